@@ -0,0 +1,6 @@
+#pragma once
+
+#include "prefix_function.h"
+#include "kmp.h"
+#include "prefix_decomposition.h"
+#include "suffix_array.h"
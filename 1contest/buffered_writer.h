@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+/*! \class BufferedWriter
+    \brief Collects output in memory and writes it to stream in big blocks
+
+    \param stream_ - stream output is written to
+    \param flush_threshold_ - buffer size after reaching which buffer is written
+    \param buffer_ - output that is not written yet
+
+    Output is never flushed per line: everything is written with one fwrite on destruction or Flush unless buffer grows
+    beyond flush_threshold_.
+*/
+class BufferedWriter {
+public:
+    static constexpr size_t kDefaultFlushThreshold = static_cast<size_t>(1) << 20;
+
+    explicit BufferedWriter(FILE *stream = stdout, size_t flush_threshold = kDefaultFlushThreshold)
+        : stream_(stream), flush_threshold_(flush_threshold), buffer_() {
+        buffer_.reserve(std::min(flush_threshold_, kDefaultFlushThreshold) + kMaxIntegerLength);
+    }
+
+    BufferedWriter(const BufferedWriter &) = delete;
+    BufferedWriter &operator=(const BufferedWriter &) = delete;
+
+    ~BufferedWriter() {
+        Flush();
+    }
+
+    /// \brief Appends string to output
+    /// \param str - appended string
+    void Write(std::string_view str) {
+        buffer_.append(str);
+        FlushIfFull();
+    }
+
+    /// \brief Appends character to output
+    /// \param symbol - appended character
+    void Write(char symbol) {
+        buffer_.push_back(symbol);
+        FlushIfFull();
+    }
+
+    /// \brief Appends decimal representation of integer to output
+    /// \param value - appended integer
+    template <typename Integer>
+    void WriteInteger(Integer value) {
+        char digits[kMaxIntegerLength];
+        char *digits_end = std::to_chars(digits, digits + kMaxIntegerLength, value).ptr;
+        buffer_.append(digits, static_cast<size_t>(digits_end - digits));
+        FlushIfFull();
+    }
+
+    /// \brief Writes collected output to stream
+    void Flush() {
+        if (!buffer_.empty()) {
+            std::fwrite(buffer_.data(), 1, buffer_.size(), stream_);
+            buffer_.clear();
+        }
+        std::fflush(stream_);
+    }
+
+private:
+    static constexpr size_t kMaxIntegerLength = 40;
+
+    /// \brief Writes collected output to stream if there is too much of it
+    void FlushIfFull() {
+        if (buffer_.size() >= flush_threshold_) {
+            std::fwrite(buffer_.data(), 1, buffer_.size(), stream_);
+            buffer_.clear();
+        }
+    }
+
+    //-----------------------------------Variables-------------------------------------
+    FILE *stream_;
+    size_t flush_threshold_;
+    std::string buffer_;
+};
@@ -1,10 +1,18 @@
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
+#include "../common/uint128.h"
+#include "buffered_writer.h"
+
 /// \brief For string with certain index in input decides if there is matching among others ones that being concatenated they form a palindrom
 /// \param input - reference to std::vector<std::string>, pool of inputted strings
 /// \param index - index of investigated string
@@ -55,22 +63,914 @@ void CheckIfSliceFormsPalindromAndMirrored(const std::vector<std::string> &input
     }
 }
 
+/*! \class WordsArena
+    \brief Words packed one after another into one contiguous buffer
+
+    \param characters_ - characters of all words
+    \param offsets_ - word with index i occupies [offsets_[i], offsets_[i + 1]) of characters_
+*/
+class WordsArena {
+public:
+    WordsArena() : characters_(), offsets_(1, 0) {
+    }
+
+    /// \brief Reserves memory so that adding words does not reallocate it
+    /// \param words_quantity - expected quantity of words
+    /// \param characters_quantity - expected total length of words
+    void Reserve(size_t words_quantity, size_t characters_quantity) {
+        offsets_.reserve(words_quantity + 1);
+        characters_.reserve(characters_quantity);
+    }
+
+    /// \brief Appends word to arena
+    /// \param word - appended word
+    /// \return Index of word
+    size_t Add(std::string_view word) {
+        characters_.append(word);
+        offsets_.push_back(characters_.size());
+
+        return offsets_.size() - 2;
+    }
+
+    /// \param index - index of word
+    /// \return std::string_view pointing into arena (valid until next Add)
+    std::string_view operator[](size_t index) const {
+        return std::string_view(characters_).substr(offsets_[index], offsets_[index + 1] - offsets_[index]);
+    }
+
+    /// \return Quantity of words
+    size_t size() const {
+        return offsets_.size() - 1;
+    }
+
+private:
+    //-----------------------------------Variables-------------------------------------
+    std::string characters_;
+    std::vector<size_t> offsets_;
+};
+
+/*! \class ReversedWordsTable
+    \brief Open addressing hash table of reversed words of WordsArena that stores words indices instead of strings
+
+    \param words_ - reference to arena with words
+    \param slots_hashes_ - hash of reversed word in slot
+    \param slots_words_ - index of word in slot or kNoWord for empty slot
+    \param mask_ - slots quantity - 1 (slots quantity is power of two)
+
+    Table is at most half full, collisions are resolved by linear probing. As std::unordered_map with assignment,
+    the last inserted index is kept among equal words.
+*/
+class ReversedWordsTable {
+public:
+    static constexpr size_t kNoWord = std::numeric_limits<size_t>::max();
+
+    explicit ReversedWordsTable(const WordsArena &words) : words_(words), slots_hashes_(), slots_words_(), mask_(0) {
+        size_t slots_quantity = 2;
+        while (slots_quantity < 2 * words_.size()) {
+            slots_quantity *= 2;
+        }
+        slots_hashes_.assign(slots_quantity, 0);
+        slots_words_.assign(slots_quantity, kNoWord);
+        mask_ = slots_quantity - 1;
+
+        for (size_t index = 0; index < words_.size(); ++index) {
+            std::string_view word = words_[index];
+            uint64_t hash = HashOf(word.crbegin(), word.crend());
+            size_t slot = static_cast<size_t>(hash) & mask_;
+            while ((slots_words_[slot] != kNoWord) &&
+                   ((slots_hashes_[slot] != hash) || (words_[slots_words_[slot]] != word))) {
+                slot = (slot + 1) & mask_;
+            }
+            slots_hashes_[slot] = hash;
+            slots_words_[slot] = index;
+        }
+    }
+
+    /// \brief Finds word which being reversed is equal to given string
+    /// \param complement - string searched for
+    /// \return Index of the last such word or kNoWord
+    size_t Find(std::string_view complement) const {
+        uint64_t hash = HashOf(complement.cbegin(), complement.cend());
+        for (size_t slot = static_cast<size_t>(hash) & mask_; slots_words_[slot] != kNoWord;
+             slot = (slot + 1) & mask_) {
+            if (slots_hashes_[slot] == hash) {
+                std::string_view candidate = words_[slots_words_[slot]];
+                if ((candidate.size() == complement.size()) &&
+                    std::equal(complement.cbegin(), complement.cend(), candidate.crbegin())) {
+                    return slots_words_[slot];
+                }
+            }
+        }
+
+        return kNoWord;
+    }
+
+private:
+    /// \brief Calculates FNV-1a hash of characters range with final mixing
+    template <typename CharIterator>
+    static uint64_t HashOf(CharIterator begin, CharIterator end) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (CharIterator char_iterator = begin; char_iterator != end; ++char_iterator) {
+            hash = (hash ^ static_cast<unsigned char>(*char_iterator)) * 1099511628211ULL;
+        }
+        hash ^= hash >> 31;
+        hash *= 0x9E3779B97F4A7C15ULL;
+
+        return hash ^ (hash >> 29);
+    }
+
+    //-----------------------------------Variables-------------------------------------
+    const WordsArena &words_;
+    std::vector<uint64_t> slots_hashes_;
+    std::vector<size_t> slots_words_;
+    size_t mask_;
+};
+
+/// \brief The same as CheckIfSliceFormsPalindromAndMirrored for words kept in WordsArena, allocates no strings
+/// \param input - reference to WordsArena, pool of inputted strings
+/// \param index - index of investigated string
+/// \param input_compact_form - reference to ReversedWordsTable of input
+/// \param indices_pairs - non-const reference of pairs of indices of strings that being concatenateed form a palindrom
+/// \param left_or_right - false means left, true - right (see CheckIfSliceFormsPalindromAndMirrored)
+void CheckIfSliceFormsPalindromAndMirrored(const WordsArena &input, size_t index,
+                                           const ReversedWordsTable &input_compact_form,
+                                           std::vector<std::pair<size_t, size_t>> &indices_pairs, bool left_or_right) {
+    std::string_view word = input[index];
+    size_t input_size = word.size();
+    for (size_t cut_pos = 0; cut_pos < input_size; ++cut_pos) {
+        bool checked_part_is_palindrom = false;
+        std::string_view complement = left_or_right ? word.substr(0, cut_pos) : word.substr(cut_pos);
+        if ((cut_pos > 0) || (left_or_right)) {
+            std::string_view checked_part = left_or_right ? word.substr(cut_pos) : word.substr(0, cut_pos);
+            auto checked_part_middle =
+                checked_part.cbegin() + static_cast<std::string_view::difference_type>(checked_part.size() / 2);
+            checked_part_is_palindrom = std::equal(checked_part.cbegin(), checked_part_middle, checked_part.crbegin());
+        }
+
+        if (((left_or_right) && (checked_part_is_palindrom)) ||
+            ((!left_or_right) && ((cut_pos == 0) || (checked_part_is_palindrom)))) {
+            size_t complement_index = input_compact_form.Find(complement);
+            if ((complement_index != ReversedWordsTable::kNoWord) && (index != complement_index)) {
+                if (left_or_right) {
+                    indices_pairs.emplace_back(index, complement_index);
+                } else {
+                    indices_pairs.emplace_back(complement_index, index);
+                }
+            }
+        }
+    }
+}
+
+/*! \struct PalindromesScratch
+    \brief Buffers reused while processing words one by one, so that no memory is allocated per word
+
+    \param palindromic_prefixes - palindromic_prefixes[length] is 1 if prefix of given length is palindrom
+    \param palindromic_suffixes - palindromic_suffixes[start] is 1 if suffix starting at start is palindrom
+    \param odd_radii - Manacher radii of odd palindroms (palindrom of length 2 * r - 1 is centered in i)
+    \param even_radii - Manacher radii of even palindroms (palindrom of length 2 * r ends right before i + r)
+    \param found_words - helper buffer for words found during the walk through trie
+*/
+struct PalindromesScratch {
+    std::vector<uint8_t> palindromic_prefixes;
+    std::vector<uint8_t> palindromic_suffixes;
+    std::vector<size_t> odd_radii;
+    std::vector<size_t> even_radii;
+    std::vector<size_t> found_words;
+};
+
+/// \brief Finds all palindromic prefixes and suffixes of word using Manacher's algorithm
+/// \param word - word that is being investigated
+/// \param scratch - reference to PalindromesScratch where palindromic_prefixes and palindromic_suffixes are filled
+///
+/// Works in O(|word|), empty prefix and empty suffix are considered palindroms
+///
+void CalculatePalindromicPrefixesAndSuffixes(std::string_view word, PalindromesScratch &scratch) {
+    size_t word_size = word.size();
+    scratch.odd_radii.assign(word_size, 0);
+    scratch.even_radii.assign(word_size, 0);
+    scratch.palindromic_prefixes.assign(word_size + 1, 0);
+    scratch.palindromic_suffixes.assign(word_size + 1, 0);
+
+    for (size_t center = 0, left = 0, right = 0; center < word_size; ++center) {  // [left, right) is rightmost
+        size_t radius = center < right ? std::min(right - center, scratch.odd_radii[left + right - center - 1]) : 1;
+        while ((radius <= center) && (center + radius < word_size) &&
+               (word[center - radius] == word[center + radius])) {
+            ++radius;
+        }
+        scratch.odd_radii[center] = radius;
+        if (center + radius > right) {
+            left = center + 1 - radius;
+            right = center + radius;
+        }
+    }
+    for (size_t center = 0, left = 0, right = 0; center < word_size; ++center) {
+        size_t radius = center < right ? std::min(right - center, scratch.even_radii[left + right - center]) : 0;
+        while ((radius < center) && (center + radius < word_size) &&
+               (word[center - radius - 1] == word[center + radius])) {
+            ++radius;
+        }
+        scratch.even_radii[center] = radius;
+        if (center + radius > right) {
+            left = center - radius;
+            right = center + radius;
+        }
+    }
+
+    scratch.palindromic_prefixes[0] = 1;
+    scratch.palindromic_suffixes[word_size] = 1;
+    for (size_t center = 0; center < word_size; ++center) {
+        size_t odd_radius = scratch.odd_radii[center];
+        if (odd_radius == center + 1) {
+            scratch.palindromic_prefixes[2 * center + 1] = 1;
+        }
+        if (center + odd_radius == word_size) {
+            scratch.palindromic_suffixes[center + 1 - odd_radius] = 1;
+        }
+
+        size_t even_radius = scratch.even_radii[center];
+        if ((even_radius > 0) && (even_radius == center)) {
+            scratch.palindromic_prefixes[2 * center] = 1;
+        }
+        if ((even_radius > 0) && (center + even_radius == word_size)) {
+            scratch.palindromic_suffixes[center - even_radius] = 1;
+        }
+    }
+}
+
+/*! \class CharTrie
+    \brief Trie of byte strings that remembers index of the last inserted string ending in node
+
+    \param first_children_ - index of the first child of node
+    \param next_siblings_ - index of the next child of the same parent
+    \param symbols_ - symbol on the edge leading to node
+    \param terminal_words_ - index of the last inserted string ending in node or kNoWord
+
+    Children are kept in singly linked lists, so the trie is compact for any alphabet
+*/
+class CharTrie {
+public:
+    static constexpr uint32_t kRoot = 0;
+    static constexpr uint32_t kNoNode = std::numeric_limits<uint32_t>::max();
+    static constexpr size_t kNoWord = std::numeric_limits<size_t>::max();
+
+    CharTrie() : first_children_(1, kNoNode), next_siblings_(1, kNoNode), symbols_(1, 0), terminal_words_(1, kNoWord) {
+    }
+
+    /// \brief Reserves memory for nodes, so that inserting does not reallocate it
+    /// \param nodes_quantity - expected quantity of nodes (total length of strings is enough)
+    void Reserve(size_t nodes_quantity) {
+        first_children_.reserve(nodes_quantity + 1);
+        next_siblings_.reserve(nodes_quantity + 1);
+        symbols_.reserve(nodes_quantity + 1);
+        terminal_words_.reserve(nodes_quantity + 1);
+    }
+
+    /// \brief Inserts string given by range of characters
+    /// \param begin - iterator to the first character
+    /// \param end - iterator after the last character
+    /// \param word_index - index string is identified by; replaces index of equal string inserted earlier
+    /// \return Node where string ends
+    template <typename CharIterator>
+    uint32_t Insert(CharIterator begin, CharIterator end, size_t word_index) {
+        uint32_t node = kRoot;
+        for (CharIterator char_iterator = begin; char_iterator != end; ++char_iterator) {
+            uint32_t child = GetChild(node, *char_iterator);
+            if (child == kNoNode) {
+                assert(symbols_.size() < kNoNode);
+
+                child = static_cast<uint32_t>(symbols_.size());
+                first_children_.push_back(kNoNode);
+                next_siblings_.push_back(first_children_[node]);
+                symbols_.push_back(*char_iterator);
+                terminal_words_.push_back(kNoWord);
+                first_children_[node] = child;
+            }
+            node = child;
+        }
+        terminal_words_[node] = word_index;
+
+        return node;
+    }
+
+    /// \brief Goes down by edge with given symbol
+    /// \param node - node where edge starts
+    /// \param symbol - symbol on edge
+    /// \return Child of node or kNoNode if there is no such edge
+    uint32_t GetChild(uint32_t node, char symbol) const {
+        uint32_t child = first_children_[node];
+        while ((child != kNoNode) && (symbols_[child] != symbol)) {
+            child = next_siblings_[child];
+        }
+
+        return child;
+    }
+
+    /// \return Quantity of nodes including root
+    size_t GetNodesQuantity() const {
+        return symbols_.size();
+    }
+
+    /// \param node - node of trie
+    /// \return Index of the last inserted string ending in node or kNoWord
+    size_t GetTerminalWord(uint32_t node) const {
+        return terminal_words_[node];
+    }
+
+private:
+    //-----------------------------------Variables-------------------------------------
+    std::vector<uint32_t> first_children_;
+    std::vector<uint32_t> next_siblings_;
+    std::vector<char> symbols_;
+    std::vector<size_t> terminal_words_;
+};
+
+/*! \class PalindromePairsTrieEngine
+    \brief Finds the same pairs as CheckIfSliceFormsPalindromAndMirrored without creating strings
+
+    \param input_ - reference to pool of inputted strings
+    \param words_trie_ - trie of inputted strings
+    \param reversed_words_trie_ - trie of reversed inputted strings
+
+    Suffix of word equal to some reversed string is found by walking reversed word in words_trie_, prefix of word
+    equal to some reversed string is found by walking word in reversed_words_trie_. Whether the remaining part of
+    word is palindrom is taken from flags calculated by Manacher's algorithm, so each word costs O(|word|) trie steps.
+*/
+class PalindromePairsTrieEngine {
+public:
+    explicit PalindromePairsTrieEngine(const std::vector<std::string> &input)
+        : input_(input), words_trie_(), reversed_words_trie_() {
+        size_t input_total_size = 0;
+        for (const std::string &word : input_) {
+            input_total_size += word.size();
+        }
+        words_trie_.Reserve(input_total_size);
+        reversed_words_trie_.Reserve(input_total_size);
+
+        for (size_t index = 0; index < input_.size(); ++index) {
+            const std::string &word = input_[index];
+            words_trie_.Insert(word.cbegin(), word.cend(), index);
+            reversed_words_trie_.Insert(word.crbegin(), word.crend(), index);
+        }
+    }
+
+    /// \brief Finds pairs formed by string with certain index, in the same order as
+    ///        CheckIfSliceFormsPalindromAndMirrored called with left_or_right = false and then true does
+    /// \param index - index of investigated string
+    /// \param scratch - reference to buffers reused between calls
+    /// \param indices_pairs - non-const reference of pairs of indices the found pairs are appended to
+    void CollectPairs(size_t index, PalindromesScratch &scratch,
+                      std::vector<std::pair<size_t, size_t>> &indices_pairs) const {
+        std::string_view word = input_[index];
+        size_t word_size = word.size();
+        CalculatePalindromicPrefixesAndSuffixes(word, scratch);
+
+        // left part: suffix of length complement_size is reversed string, prefix before it is palindrom
+        scratch.found_words.assign(word_size + 1, CharTrie::kNoWord);
+        uint32_t node = CharTrie::kRoot;
+        for (size_t complement_size = 1; complement_size <= word_size; ++complement_size) {
+            node = words_trie_.GetChild(node, word[word_size - complement_size]);
+            if (node == CharTrie::kNoNode) {
+                break;
+            }
+
+            size_t cut_pos = word_size - complement_size;
+            if ((cut_pos == 0) || (scratch.palindromic_prefixes[cut_pos] != 0)) {
+                scratch.found_words[cut_pos] = words_trie_.GetTerminalWord(node);
+            }
+        }
+        for (size_t cut_pos = 0; cut_pos < word_size; ++cut_pos) {
+            size_t complement_index = scratch.found_words[cut_pos];
+            if ((complement_index != CharTrie::kNoWord) && (complement_index != index)) {
+                indices_pairs.emplace_back(complement_index, index);
+            }
+        }
+
+        // right part: prefix of length cut_pos is reversed string, non-empty suffix after it is palindrom
+        node = CharTrie::kRoot;
+        for (size_t cut_pos = 0; cut_pos < word_size; ++cut_pos) {
+            if (cut_pos > 0) {
+                node = reversed_words_trie_.GetChild(node, word[cut_pos - 1]);
+                if (node == CharTrie::kNoNode) {
+                    break;
+                }
+            }
+
+            size_t complement_index = reversed_words_trie_.GetTerminalWord(node);
+            if ((complement_index != CharTrie::kNoWord) && (complement_index != index) &&
+                (scratch.palindromic_suffixes[cut_pos] != 0)) {
+                indices_pairs.emplace_back(index, complement_index);
+            }
+        }
+    }
+
+private:
+    //-----------------------------------Variables-------------------------------------
+    const std::vector<std::string> &input_;
+    CharTrie words_trie_;
+    CharTrie reversed_words_trie_;
+};
+
+/*! \struct RollingHashScratch
+    \brief Buffers with polynomial hashes of prefixes reused while processing words one by one
+
+    \param hashes - hashes[length] is hash of prefix of word of given length
+    \param reversed_hashes - reversed_hashes[length] is hash of prefix of reversed word of given length
+*/
+struct RollingHashScratch {
+    std::vector<uint64_t> hashes;
+    std::vector<uint64_t> reversed_hashes;
+};
+
+/*! \class PalindromePairsHashEngine
+    \brief Finds the same pairs as CheckIfSliceFormsPalindromAndMirrored using polynomial hashes
+
+    \param input_ - reference to pool of inputted strings
+    \param powers_ - powers of kBase modulo kModulus up to the longest string length
+    \param first_entries_ - maps hash of reversed string to the first entry with such hash
+    \param entries_words_ - index of string (the last one among equal strings) stored in entry
+    \param next_entries_ - next entry with the same hash or kNoEntry
+
+    Hashes of prefixes of word and of reversed word are calculated once per word, after that both "is slice
+    palindrom" and "hash of complement" are O(1). Lookup table is keyed by 64-bit hash and refers to strings by index;
+    every hit is verified by comparing characters, so the result is exact whatever collisions happen.
+*/
+class PalindromePairsHashEngine {
+public:
+    static constexpr uint64_t kModulus = (static_cast<uint64_t>(1) << 61) - 1;
+    static constexpr uint64_t kBase = 1'000'000'007;
+
+    explicit PalindromePairsHashEngine(const std::vector<std::string> &input)
+        : input_(input), powers_(1, 1), first_entries_(), entries_words_(), next_entries_() {
+        size_t max_word_size = 0;
+        for (const std::string &word : input_) {
+            max_word_size = std::max(max_word_size, word.size());
+        }
+        powers_.resize(max_word_size + 1);
+        for (size_t power = 1; power <= max_word_size; ++power) {
+            powers_[power] = MultiplyModulo(powers_[power - 1], kBase);
+        }
+
+        first_entries_.reserve(input_.size());
+        for (size_t index = 0; index < input_.size(); ++index) {
+            const std::string &word = input_[index];
+            uint64_t reversed_hash = 0;
+            for (auto word_iterator = word.crbegin(); word_iterator != word.crend(); ++word_iterator) {
+                reversed_hash = AppendSymbol(reversed_hash, *word_iterator);
+            }
+
+            auto [first_entry_iterator, is_inserted] = first_entries_.try_emplace(reversed_hash, kNoEntry);
+            size_t entry = first_entry_iterator->second;
+            while ((entry != kNoEntry) && (input_[entries_words_[entry]] != word)) {
+                entry = next_entries_[entry];
+            }
+            if (entry != kNoEntry) {
+                entries_words_[entry] = index;
+            } else {
+                entries_words_.push_back(index);
+                next_entries_.push_back(first_entry_iterator->second);
+                first_entry_iterator->second = entries_words_.size() - 1;
+            }
+        }
+    }
+
+    /// \brief Finds pairs formed by string with certain index, in the same order as
+    ///        CheckIfSliceFormsPalindromAndMirrored called with left_or_right = false and then true does
+    /// \param index - index of investigated string
+    /// \param scratch - reference to buffers reused between calls
+    /// \param indices_pairs - non-const reference of pairs of indices the found pairs are appended to
+    void CollectPairs(size_t index, RollingHashScratch &scratch,
+                      std::vector<std::pair<size_t, size_t>> &indices_pairs) const {
+        std::string_view word = input_[index];
+        size_t word_size = word.size();
+        scratch.hashes.resize(word_size + 1);
+        scratch.reversed_hashes.resize(word_size + 1);
+        scratch.hashes[0] = 0;
+        scratch.reversed_hashes[0] = 0;
+        for (size_t length = 1; length <= word_size; ++length) {
+            scratch.hashes[length] = AppendSymbol(scratch.hashes[length - 1], word[length - 1]);
+            scratch.reversed_hashes[length] =
+                AppendSymbol(scratch.reversed_hashes[length - 1], word[word_size - length]);
+        }
+
+        // left part: suffix starting at cut_pos is reversed string, prefix before it is palindrom
+        for (size_t cut_pos = 0; cut_pos < word_size; ++cut_pos) {
+            if ((cut_pos == 0) || IsSlicePalindromByHash(scratch, word_size, 0, cut_pos)) {
+                size_t complement_index = FindReversed(word.substr(cut_pos), GetSliceHash(scratch, cut_pos, word_size));
+                if ((complement_index != kNoWord) && (complement_index != index) &&
+                    ((cut_pos == 0) || IsSlicePalindrom(word.substr(0, cut_pos)))) {
+                    indices_pairs.emplace_back(complement_index, index);
+                }
+            }
+        }
+
+        // right part: prefix of length cut_pos is reversed string, non-empty suffix after it is palindrom
+        for (size_t cut_pos = 0; cut_pos < word_size; ++cut_pos) {
+            if (IsSlicePalindromByHash(scratch, word_size, cut_pos, word_size)) {
+                size_t complement_index = FindReversed(word.substr(0, cut_pos), GetSliceHash(scratch, 0, cut_pos));
+                if ((complement_index != kNoWord) && (complement_index != index) &&
+                    IsSlicePalindrom(word.substr(cut_pos))) {
+                    indices_pairs.emplace_back(index, complement_index);
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr size_t kNoEntry = std::numeric_limits<size_t>::max();
+    static constexpr size_t kNoWord = std::numeric_limits<size_t>::max();
+
+    /// \brief Multiplies two numbers modulo kModulus
+    static uint64_t MultiplyModulo(uint64_t first, uint64_t second) {
+        UnsignedInt128 product = static_cast<UnsignedInt128>(first) * second;
+        uint64_t result = static_cast<uint64_t>(product & kModulus) + static_cast<uint64_t>(product >> 61);
+
+        return result >= kModulus ? result - kModulus : result;
+    }
+
+    /// \brief Calculates hash of string with symbol appended
+    /// \param hash - hash of string
+    /// \param symbol - appended symbol
+    /// \return Hash of longer string
+    static uint64_t AppendSymbol(uint64_t hash, char symbol) {
+        uint64_t result = MultiplyModulo(hash, kBase) + static_cast<unsigned char>(symbol) + 1;
+
+        return result >= kModulus ? result - kModulus : result;
+    }
+
+    /// \brief Calculates hash of slice [begin, end) of word from hashes of its prefixes
+    uint64_t GetSliceHash(const RollingHashScratch &scratch, size_t begin, size_t end) const {
+        uint64_t subtrahend = MultiplyModulo(scratch.hashes[begin], powers_[end - begin]);
+
+        return scratch.hashes[end] >= subtrahend ? scratch.hashes[end] - subtrahend
+                                                 : scratch.hashes[end] + kModulus - subtrahend;
+    }
+
+    /// \brief Calculates hash of slice [begin, end) of reversed word from hashes of its prefixes
+    uint64_t GetReversedSliceHash(const RollingHashScratch &scratch, size_t begin, size_t end) const {
+        uint64_t subtrahend = MultiplyModulo(scratch.reversed_hashes[begin], powers_[end - begin]);
+
+        return scratch.reversed_hashes[end] >= subtrahend ? scratch.reversed_hashes[end] - subtrahend
+                                                          : scratch.reversed_hashes[end] + kModulus - subtrahend;
+    }
+
+    /// \brief Checks in O(1) whether slice [begin, end) of word is palindrom (may be wrong on collision)
+    bool IsSlicePalindromByHash(const RollingHashScratch &scratch, size_t word_size, size_t begin, size_t end) const {
+        return GetSliceHash(scratch, begin, end) == GetReversedSliceHash(scratch, word_size - end, word_size - begin);
+    }
+
+    /// \brief Checks whether slice is palindrom comparing its characters
+    static bool IsSlicePalindrom(std::string_view slice) {
+        auto slice_middle = slice.cbegin() + static_cast<std::string_view::difference_type>(slice.size() / 2);
+
+        return std::equal(slice.cbegin(), slice_middle, slice.crbegin());
+    }
+
+    /// \brief Finds string which being reversed is equal to complement
+    /// \param complement - slice of investigated word
+    /// \param complement_hash - hash of complement
+    /// \return Index of the last such string in input or kNoWord
+    size_t FindReversed(std::string_view complement, uint64_t complement_hash) const {
+        auto first_entry_iterator = first_entries_.find(complement_hash);
+        if (first_entry_iterator == first_entries_.end()) {
+            return kNoWord;
+        }
+
+        for (size_t entry = first_entry_iterator->second; entry != kNoEntry; entry = next_entries_[entry]) {
+            const std::string &candidate = input_[entries_words_[entry]];
+            if ((candidate.size() == complement.size()) &&
+                std::equal(complement.cbegin(), complement.cend(), candidate.crbegin())) {
+                return entries_words_[entry];
+            }
+        }
+
+        return kNoWord;
+    }
+
+    //-----------------------------------Variables-------------------------------------
+    const std::vector<std::string> &input_;
+    std::vector<uint64_t> powers_;
+    std::unordered_map<uint64_t, size_t> first_entries_;
+    std::vector<size_t> entries_words_;
+    std::vector<size_t> next_entries_;
+};
+
+/*! \struct ParallelPalindromePairsOptions
+    \brief Settings of CollectPalindromePairsInParallel
+
+    \param threads_quantity - quantity of threads; 0 means std::thread::hardware_concurrency()
+    \param words_block_size - quantity of words taken by thread at a time
+    \param keep_order - whether pairs are returned in the same order as sequential loop over words gives
+*/
+struct ParallelPalindromePairsOptions {
+    size_t threads_quantity = 0;
+    size_t words_block_size = 256;
+    bool keep_order = true;
+};
+
+/// \brief Finds palindrom pairs for all words using several threads
+/// \param words_quantity - quantity of words
+/// \param collect_pairs_of_word - callable (index, pairs) appending pairs formed by word with index to pairs;
+///                                it is copied to each thread, so scratch buffers captured by value are not shared
+/// \param options - reference to threads quantity, block size and order settings
+/// \return std::vector with pairs of indices of strings that being concatenated form a palindrom
+///
+/// Threads take blocks of words one by one. If order is kept, every block has its own result buffer and buffers
+/// are concatenated in blocks order; otherwise every thread appends to its own buffer.
+///
+template <typename CollectPairsOfWord>
+std::vector<std::pair<size_t, size_t>> CollectPalindromePairsInParallel(
+    size_t words_quantity, const CollectPairsOfWord &collect_pairs_of_word,
+    const ParallelPalindromePairsOptions &options = {}) {
+    size_t words_block_size = std::max<size_t>(options.words_block_size, 1);
+    size_t blocks_quantity = (words_quantity + words_block_size - 1) / words_block_size;
+    size_t threads_quantity = options.threads_quantity;
+    if (threads_quantity == 0) {
+        threads_quantity = std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+    }
+    threads_quantity = std::max<size_t>(std::min(threads_quantity, blocks_quantity), 1);
+
+    std::vector<std::vector<std::pair<size_t, size_t>>> buffers(options.keep_order ? blocks_quantity
+                                                                                    : threads_quantity);
+    std::atomic<size_t> next_block{0};
+    auto collect_blocks = [&](size_t thread_index) {
+        CollectPairsOfWord thread_collect_pairs_of_word = collect_pairs_of_word;
+        for (size_t block = next_block++; block < blocks_quantity; block = next_block++) {
+            size_t block_begin = block * words_block_size;
+            size_t block_end = std::min(block_begin + words_block_size, words_quantity);
+            std::vector<std::pair<size_t, size_t>> &indices_pairs =
+                buffers[options.keep_order ? block : thread_index];
+            for (size_t index = block_begin; index < block_end; ++index) {
+                thread_collect_pairs_of_word(index, indices_pairs);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threads_quantity - 1);
+    for (size_t thread_index = 1; thread_index < threads_quantity; ++thread_index) {
+        threads.emplace_back(collect_blocks, thread_index);
+    }
+    collect_blocks(0);
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    size_t pairs_quantity = 0;
+    for (const std::vector<std::pair<size_t, size_t>> &buffer : buffers) {
+        pairs_quantity += buffer.size();
+    }
+    std::vector<std::pair<size_t, size_t>> indices_pairs{};
+    indices_pairs.reserve(pairs_quantity);
+    for (const std::vector<std::pair<size_t, size_t>> &buffer : buffers) {
+        indices_pairs.insert(indices_pairs.end(), buffer.cbegin(), buffer.cend());
+    }
+
+    return indices_pairs;
+}
+
+/*! \class DynamicPalindromePairsIndex
+    \brief Set of words that changes over time and reports palindrom pairs each inserted word creates
+
+    \param words_ - inserted words, word is identified by its index here
+    \param are_alive_ - whether word was not removed
+    \param words_trie_ - trie of words
+    \param reversed_words_trie_ - trie of reversed words
+    \param words_trie_terminals_ - words ending in node of words_trie_
+    \param words_trie_tails_ - words going through node of words_trie_ deeper whose remaining part is palindrom
+    \param reversed_words_trie_terminals_ - reversed words ending in node of reversed_words_trie_
+    \param reversed_words_trie_tails_ - reversed words going through node of reversed_words_trie_ deeper whose
+                                        remaining part is palindrom
+    \param scratch_ - buffers for palindromic prefixes and suffixes of processed word
+    \param alive_weight_ - total size plus quantity of alive words
+    \param dead_weight_ - total size plus quantity of removed words that are still in tries
+
+    Pair (x, w) is found either as suffix of w that is reversed x with palindromic rest of w (walk of reversed w in
+    words_trie_), or as x that begins with reversed w and has palindromic rest (tails of the node where the walk ends).
+    Pairs (w, x) are found symmetrically in reversed_words_trie_. So AddWord costs O(|word|) trie steps plus the
+    quantity of reported pairs. RemoveWord only marks word dead; dead words are dropped from node lists when a walk
+    meets them, which is paid for by their insertion. Once removed words outweigh alive ones, tries and node lists
+    are rebuilt from alive words, so their memory is O(total size of alive words) and rebuilding is paid for by
+    removals. Indices stay stable, so words_ and are_alive_ keep an empty slot per removed word.
+*/
+class DynamicPalindromePairsIndex {
+public:
+    DynamicPalindromePairsIndex()
+        : words_()
+        , are_alive_()
+        , words_trie_()
+        , reversed_words_trie_()
+        , words_trie_terminals_(1)
+        , words_trie_tails_(1)
+        , reversed_words_trie_terminals_(1)
+        , reversed_words_trie_tails_(1)
+        , scratch_()
+        , alive_weight_(0)
+        , dead_weight_(0) {
+    }
+
+    /// \brief Inserts word and finds pairs it forms with words that are already in index
+    /// \param word - inserted word
+    /// \param new_pairs - non-const reference to vector where pairs (first, second) of words indices such that
+    ///                    words[first] + words[second] is palindrom are appended
+    /// \return Index of inserted word
+    size_t AddWord(std::string word, std::vector<std::pair<size_t, size_t>> &new_pairs) {
+        size_t index = words_.size();
+        size_t word_size = word.size();
+        CalculatePalindromicPrefixesAndSuffixes(word, scratch_);
+
+        // pairs (x, word): x is reversed suffix of word, or x = reversed word + palindrom
+        uint32_t node = CharTrie::kRoot;
+        for (size_t complement_size = 0; complement_size <= word_size; ++complement_size) {
+            if (complement_size > 0) {
+                node = words_trie_.GetChild(node, word[word_size - complement_size]);
+                if (node == CharTrie::kNoNode) {
+                    break;
+                }
+            }
+
+            if (scratch_.palindromic_prefixes[word_size - complement_size] != 0) {
+                CollectAlive(words_trie_terminals_[node], index, false, new_pairs);
+            }
+            if (complement_size == word_size) {
+                CollectAlive(words_trie_tails_[node], index, false, new_pairs);
+            }
+        }
+
+        // pairs (word, x): reversed x is prefix of word, or reversed x = word + palindrom
+        node = CharTrie::kRoot;
+        for (size_t complement_size = 0; complement_size <= word_size; ++complement_size) {
+            if (complement_size > 0) {
+                node = reversed_words_trie_.GetChild(node, word[complement_size - 1]);
+                if (node == CharTrie::kNoNode) {
+                    break;
+                }
+            }
+
+            if (scratch_.palindromic_suffixes[complement_size] != 0) {
+                CollectAlive(reversed_words_trie_terminals_[node], index, true, new_pairs);
+            }
+            if (complement_size == word_size) {
+                CollectAlive(reversed_words_trie_tails_[node], index, true, new_pairs);
+            }
+        }
+
+        InsertIntoTrie(word.cbegin(), word.cend(), scratch_.palindromic_suffixes, false, index, words_trie_,
+                       words_trie_terminals_, words_trie_tails_);
+        InsertIntoTrie(word.crbegin(), word.crend(), scratch_.palindromic_prefixes, true, index, reversed_words_trie_,
+                       reversed_words_trie_terminals_, reversed_words_trie_tails_);
+        words_.push_back(std::move(word));
+        are_alive_.push_back(1);
+        alive_weight_ += word_size + 1;
+
+        return index;
+    }
+
+    /// \brief Removes word from index
+    /// \param index - index of word returned by AddWord
+    /// \return false if word was already removed
+    bool RemoveWord(size_t index) {
+        assert(index < words_.size());
+
+        if (are_alive_[index] == 0) {
+            return false;
+        }
+        are_alive_[index] = 0;
+        alive_weight_ -= words_[index].size() + 1;
+        dead_weight_ += words_[index].size() + 1;
+        std::string().swap(words_[index]);
+        if (dead_weight_ > alive_weight_) {
+            Rebuild();
+        }
+
+        return true;
+    }
+
+    /// \param index - index of word returned by AddWord
+    /// \return Word with given index (empty if it was removed)
+    const std::string &GetWord(size_t index) const {
+        return words_[index];
+    }
+
+private:
+    /// \brief Rebuilds tries and node lists from alive words, releasing memory held by removed ones
+    void Rebuild() {
+        words_trie_ = CharTrie();
+        reversed_words_trie_ = CharTrie();
+        words_trie_.Reserve(alive_weight_);
+        reversed_words_trie_.Reserve(alive_weight_);
+        words_trie_terminals_.assign(1, {});
+        words_trie_tails_.assign(1, {});
+        reversed_words_trie_terminals_.assign(1, {});
+        reversed_words_trie_tails_.assign(1, {});
+
+        for (size_t index = 0; index < words_.size(); ++index) {
+            if (are_alive_[index] == 0) {
+                continue;
+            }
+
+            const std::string &word = words_[index];
+            CalculatePalindromicPrefixesAndSuffixes(word, scratch_);
+            InsertIntoTrie(word.cbegin(), word.cend(), scratch_.palindromic_suffixes, false, index, words_trie_,
+                           words_trie_terminals_, words_trie_tails_);
+            InsertIntoTrie(word.crbegin(), word.crend(), scratch_.palindromic_prefixes, true, index,
+                           reversed_words_trie_, reversed_words_trie_terminals_, reversed_words_trie_tails_);
+        }
+        words_trie_terminals_.shrink_to_fit();
+        words_trie_tails_.shrink_to_fit();
+        reversed_words_trie_terminals_.shrink_to_fit();
+        reversed_words_trie_tails_.shrink_to_fit();
+        dead_weight_ = 0;
+    }
+
+    /// \brief Appends pairs of word with alive words from list and drops dead words from it
+    /// \param list - reference to list of words indices in node
+    /// \param index - index of inserted word
+    /// \param is_inserted_first - whether inserted word goes first in pair
+    /// \param new_pairs - non-const reference to vector pairs are appended to
+    void CollectAlive(std::vector<size_t> &list, size_t index, bool is_inserted_first,
+                      std::vector<std::pair<size_t, size_t>> &new_pairs) {
+        auto list_end = std::remove_if(list.begin(), list.end(),
+                                       [&](size_t complement_index) { return are_alive_[complement_index] == 0; });
+        list.erase(list_end, list.end());
+        for (size_t complement_index : list) {
+            if (is_inserted_first) {
+                new_pairs.emplace_back(index, complement_index);
+            } else {
+                new_pairs.emplace_back(complement_index, index);
+            }
+        }
+    }
+
+    /// \brief Inserts word into trie filling node lists
+    /// \param begin - iterator to the first character inserted into trie
+    /// \param end - iterator after the last character inserted into trie
+    /// \param palindromic_rests - flags telling whether the rest of inserted characters after depth is palindrom;
+    ///                            indexed by depth if is_reversed is false and by size - depth otherwise
+    /// \param is_reversed - whether characters go in reversed order
+    /// \param index - index of inserted word
+    /// \param trie - reference to trie
+    /// \param terminals - reference to lists of words ending in nodes of trie
+    /// \param tails - reference to lists of words with palindromic rest below nodes of trie
+    template <typename CharIterator>
+    static void InsertIntoTrie(CharIterator begin, CharIterator end, const std::vector<uint8_t> &palindromic_rests,
+                               bool is_reversed, size_t index, CharTrie &trie,
+                               std::vector<std::vector<size_t>> &terminals,
+                               std::vector<std::vector<size_t>> &tails) {
+        uint32_t end_node = trie.Insert(begin, end, index);
+        terminals.resize(trie.GetNodesQuantity());
+        tails.resize(trie.GetNodesQuantity());
+        terminals[end_node].push_back(index);
+
+        size_t size = static_cast<size_t>(end - begin);
+        uint32_t node = CharTrie::kRoot;
+        size_t depth = 0;
+        for (CharIterator char_iterator = begin; char_iterator != end; ++char_iterator) {
+            if (palindromic_rests[is_reversed ? size - depth : depth] != 0) {
+                tails[node].push_back(index);
+            }
+
+            node = trie.GetChild(node, *char_iterator);
+            ++depth;
+        }
+    }
+
+    //-----------------------------------Variables-------------------------------------
+    std::vector<std::string> words_;
+    std::vector<uint8_t> are_alive_;
+    CharTrie words_trie_;
+    CharTrie reversed_words_trie_;
+    std::vector<std::vector<size_t>> words_trie_terminals_;
+    std::vector<std::vector<size_t>> words_trie_tails_;
+    std::vector<std::vector<size_t>> reversed_words_trie_terminals_;
+    std::vector<std::vector<size_t>> reversed_words_trie_tails_;
+    PalindromesScratch scratch_;
+    size_t alive_weight_;
+    size_t dead_weight_;
+};
+
 int main() {
+    std::ios::sync_with_stdio(false);
+
     size_t n = 0;
     std::cin >> n;
 
-    std::vector<std::string> input(n);
-    auto input_begin = input.begin();
-    auto input_iterator = input_begin;
-    auto input_end = input.end();
-    std::unordered_map<std::string, size_t> input_compact_form{};
-    while (input_iterator != input_end) {
-        std::cin >> *input_iterator;
-        input_compact_form[std::string(input_iterator->crbegin(), input_iterator->crend())] =
-            input_iterator - input_begin;
+    // when stdin is a file, its rest bounds total length of words, so arena buffers never grow by doubling
+    size_t characters_quantity = 0;
+    std::streampos words_begin = std::cin.tellg();
+    if ((words_begin != std::streampos(-1)) && std::cin.seekg(0, std::ios::end)) {
+        characters_quantity = static_cast<size_t>(std::cin.tellg() - words_begin);
+        std::cin.seekg(words_begin);
+    }
+    std::cin.clear();
 
-        ++input_iterator;
+    WordsArena input;
+    input.Reserve(n, characters_quantity);
+    std::string word;
+    for (size_t i = 0; i < n; ++i) {
+        std::cin >> word;
+        input.Add(word);
     }
+    ReversedWordsTable input_compact_form(input);
 
     std::vector<std::pair<size_t, size_t>> indices_pairs{};
     for (size_t i = 0; i < n; ++i) {
@@ -78,14 +978,19 @@ int main() {
         CheckIfSliceFormsPalindromAndMirrored(input, i, input_compact_form, indices_pairs, true);
     }
 
-    std::cout << indices_pairs.size() << std::endl;
+    BufferedWriter writer;
+    writer.WriteInteger(indices_pairs.size());
+    writer.Write('\n');
     auto indices_pairs_iterator = indices_pairs.cbegin();
     auto indices_pairs_end = indices_pairs.cend();
     while (indices_pairs_iterator != indices_pairs_end) {
-        std::cout << indices_pairs_iterator->first + 1 << " " << indices_pairs_iterator->second + 1 << std::endl;
+        writer.WriteInteger(indices_pairs_iterator->first + 1);
+        writer.Write(' ');
+        writer.WriteInteger(indices_pairs_iterator->second + 1);
+        writer.Write('\n');
 
         ++indices_pairs_iterator;
     }
 
     return 0;
-}
\ No newline at end of file
+}
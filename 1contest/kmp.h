@@ -0,0 +1,630 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "prefix_function.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define KMP_PREFILTER_X86
+#endif
+
+/// \brief Knuth-Morris-Pratt algorithm with prefix function values stored as IndexType
+/// \param text - string where pattern is being searched
+/// \param pattern - string that is being searched in text
+/// \param pattern_prefixes_only - whether prefix function is kept only for pattern and text part is never stored
+/// \return std::vector<size_t> with indexes of pattern enterings in text
+///
+/// Any byte values are allowed both in text and in pattern
+///
+template <typename IndexType>
+std::vector<size_t> KmpOfIndexType(std::string_view text, std::string_view pattern, bool pattern_prefixes_only) {
+    size_t pattern_size = pattern.size();
+    std::vector<size_t> beginnings{};
+    if ((!pattern_prefixes_only) || (pattern_size == 0)) {
+        std::vector<IndexType> prefixes = CalculateConcatenationPrefixes<IndexType>(pattern, text);
+
+        auto prefixes_begin = prefixes.cbegin();
+        auto prefixes_end = prefixes.cend();
+        auto prefixes_iterator = prefixes_begin;
+        while (prefixes_iterator != prefixes_end) {
+            if (*prefixes_iterator == pattern_size) {
+                beginnings.push_back(static_cast<size_t>(prefixes_iterator - prefixes_begin) + 1 - pattern_size);
+            }
+
+            ++prefixes_iterator;
+        }
+
+        return beginnings;
+    }
+
+    std::vector<IndexType> prefixes = CalculatePrefixes<IndexType>(pattern);
+    IndexType border_length = 0;
+    auto text_begin = text.cbegin();
+    auto text_end = text.cend();
+    auto text_iterator = text_begin;
+    while (text_iterator != text_end) {
+        border_length = AdvanceBorder(pattern, prefixes.data(), border_length, *text_iterator);
+
+        ++text_iterator;
+        if (border_length == pattern_size) {
+            beginnings.push_back(static_cast<size_t>(text_iterator - text_begin) - pattern_size);
+        }
+    }
+
+    return beginnings;
+}
+
+/// \brief Knuth-Morris-Pratt algorithm
+/// \param text - string where pattern is being searched
+/// \param pattern - string that is being searched in text
+/// \param pattern_prefixes_only - whether prefix function is kept only for pattern and text part is never stored
+/// \return std::vector<size_t> with indexes of pattern enterings in text
+///
+/// Prefix function values are stored as uint32_t if they fit, otherwise as size_t
+///
+inline std::vector<size_t> Kmp(std::string_view text, std::string_view pattern, bool pattern_prefixes_only = false) {
+    if (pattern.size() + text.size() < std::numeric_limits<uint32_t>::max()) {
+        return KmpOfIndexType<uint32_t>(text, pattern, pattern_prefixes_only);
+    }
+
+    return KmpOfIndexType<size_t>(text, pattern, pattern_prefixes_only);
+}
+
+namespace kmp_prefilter {
+/// Candidate is position where both the first and the last pattern characters are found
+using CandidateFinder = const char *(*)(const char *begin, const char *end, char first, char last,
+                                         size_t last_offset);
+
+/// \brief Finds the first candidate for pattern entering beginning
+/// \param begin - pointer to the first position that may be candidate
+/// \param end - pointer after the last position that may be candidate (so end[last_offset - 1] is readable)
+/// \param first - the first character of pattern
+/// \param last - the last character of pattern
+/// \param last_offset - pattern size - 1
+/// \return Pointer to candidate or end if there is no candidate
+inline const char *FindCandidateScalar(const char *begin, const char *end, char first, char last, size_t last_offset) {
+    while (begin != end) {
+        const void *first_found = std::memchr(begin, first, static_cast<size_t>(end - begin));
+        if (first_found == nullptr) {
+            return end;
+        }
+
+        begin = static_cast<const char *>(first_found);
+        if (begin[last_offset] == last) {
+            return begin;
+        }
+
+        ++begin;
+    }
+
+    return end;
+}
+
+#ifdef KMP_PREFILTER_X86
+/// \brief SSE2 version of FindCandidateScalar: checks 16 positions at once
+inline const char *FindCandidateSse2(const char *begin, const char *end, char first, char last, size_t last_offset) {
+    const __m128i firsts = _mm_set1_epi8(first);
+    const __m128i lasts = _mm_set1_epi8(last);
+    while (end - begin >= 16) {
+        __m128i first_block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+        __m128i last_block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin + last_offset));
+        auto mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first_block, firsts), _mm_cmpeq_epi8(last_block, lasts))));
+        if (mask != 0) {
+            return begin + __builtin_ctz(mask);
+        }
+
+        begin += 16;
+    }
+
+    return FindCandidateScalar(begin, end, first, last, last_offset);
+}
+
+/// \brief AVX2 version of FindCandidateScalar: checks 32 positions at once
+inline __attribute__((target("avx2"))) const char *FindCandidateAvx2(const char *begin, const char *end,
+                                                                      char first, char last, size_t last_offset) {
+    const __m256i firsts = _mm256_set1_epi8(first);
+    const __m256i lasts = _mm256_set1_epi8(last);
+    while (end - begin >= 32) {
+        __m256i first_block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+        __m256i last_block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin + last_offset));
+        auto mask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(first_block, firsts), _mm256_cmpeq_epi8(last_block, lasts))));
+        if (mask != 0) {
+            return begin + __builtin_ctz(mask);
+        }
+
+        begin += 32;
+    }
+
+    return FindCandidateSse2(begin, end, first, last, last_offset);
+}
+#endif
+
+/// \brief Chooses the widest candidate finder supported by processor
+/// \return Pointer to candidate finder
+inline CandidateFinder ChooseCandidateFinder() {
+#ifdef KMP_PREFILTER_X86
+    if (__builtin_cpu_supports("avx2")) {
+        return FindCandidateAvx2;
+    }
+
+    return FindCandidateSse2;
+#else
+    return FindCandidateScalar;
+#endif
+}
+}  // namespace kmp_prefilter
+
+/// \brief Knuth-Morris-Pratt algorithm that skips positions which can not begin pattern entering
+/// \param text - string where pattern is being searched
+/// \param pattern - string that is being searched in text
+/// \return std::vector<size_t> with indexes of pattern enterings in text (the same as Kmp returns)
+///
+/// Whenever automaton returns to the initial state, next position where text has both the first and the last
+/// characters of pattern on right distances is found with SIMD instructions, and automaton continues from there.
+/// Finder never scans a position twice, so the whole search remains linear.
+///
+inline std::vector<size_t> KmpWithPrefilter(std::string_view text, std::string_view pattern) {
+    static const kmp_prefilter::CandidateFinder kFindCandidate = kmp_prefilter::ChooseCandidateFinder();
+
+    std::vector<size_t> beginnings{};
+    size_t text_size = text.size();
+    size_t pattern_size = pattern.size();
+    if ((pattern_size == 0) || (pattern_size > text_size)) {
+        return pattern_size == 0 ? Kmp(text, pattern) : beginnings;
+    }
+
+    std::vector<size_t> prefixes = CalculatePrefixes(pattern);
+    const char *text_begin = text.data();
+    size_t candidates_quantity = text_size - pattern_size + 1;
+    const char *candidates_end = text_begin + candidates_quantity;
+    char pattern_first = pattern.front();
+    char pattern_last = pattern.back();
+    size_t border_length = 0;
+    size_t text_index = 0;
+    while (text_index < text_size) {
+        if (border_length == 0) {
+            if (text_index >= candidates_quantity) {
+                break;
+            }
+            const char *candidate = kFindCandidate(text_begin + text_index, candidates_end, pattern_first,
+                                                   pattern_last, pattern_size - 1);
+            if (candidate == candidates_end) {
+                break;
+            }
+            text_index = static_cast<size_t>(candidate - text_begin);
+        }
+
+        border_length = AdvanceBorder(pattern, prefixes.data(), border_length, text[text_index]);
+        if (border_length == pattern_size) {
+            beginnings.push_back(text_index + 1 - pattern_size);
+        }
+
+        ++text_index;
+    }
+
+    return beginnings;
+}
+
+/*! \class StreamingKmpMatcher
+    \brief Knuth-Morris-Pratt automaton that receives text in chunks of arbitrary size
+
+    \param pattern_ - string that is being searched
+    \param prefixes_ - prefix function of pattern_
+    \param border_length_ - length of the longest suffix of already processed text that is prefix of pattern_
+    \param processed_quantity_ - quantity of text characters that were already processed
+
+    Prefix function is calculated only for pattern, so memory usage is O(|pattern|) whatever the text length is.
+    Chunk may end at any position (even inside of pattern entering): the state is kept between calls.
+    Memory-mapped file may be passed as one chunk to Feed.
+*/
+class StreamingKmpMatcher {
+public:
+    explicit StreamingKmpMatcher(std::string pattern)
+        : pattern_(std::move(pattern)), prefixes_(), border_length_(0), processed_quantity_(0) {
+        assert(!pattern_.empty());
+
+        prefixes_ = CalculatePrefixes(pattern_);
+    }
+
+    /// \brief Processes next chunk of text
+    /// \param chunk - pointer to the first character of chunk
+    /// \param chunk_size - quantity of characters in chunk
+    /// \param on_entering - callable that receives index of pattern entering in the whole text as soon as it is found
+    template <typename Callback>
+    void Feed(const char *chunk, size_t chunk_size, Callback &&on_entering) {
+        size_t pattern_size = pattern_.size();
+        const char *chunk_end = chunk + chunk_size;
+        for (const char *chunk_iterator = chunk; chunk_iterator != chunk_end; ++chunk_iterator) {
+            border_length_ = AdvanceBorder(pattern_, prefixes_.data(), border_length_, *chunk_iterator);
+
+            ++processed_quantity_;
+            if (border_length_ == pattern_size) {
+                on_entering(processed_quantity_ - pattern_size);
+            }
+        }
+    }
+
+    /// \brief Processes next chunk of text
+    /// \param chunk - chunk of text
+    /// \param on_entering - callable that receives index of pattern entering in the whole text as soon as it is found
+    template <typename Callback>
+    void Feed(std::string_view chunk, Callback &&on_entering) {
+        Feed(chunk.data(), chunk.size(), std::forward<Callback>(on_entering));
+    }
+
+    /// \brief Processes the whole stream reading it by chunks
+    /// \param in - stream text is read from (until its end)
+    /// \param chunk_size - quantity of characters read at once
+    /// \param on_entering - callable that receives index of pattern entering in the whole text as soon as it is found
+    template <typename Callback>
+    void Feed(std::istream &in, size_t chunk_size, Callback &&on_entering) {
+        assert(chunk_size != 0);
+
+        std::string chunk(chunk_size, '\0');
+        while (in) {
+            in.read(chunk.data(), static_cast<std::streamsize>(chunk_size));
+            Feed(chunk.data(), static_cast<size_t>(in.gcount()), on_entering);
+        }
+    }
+
+    /// \brief Processes text that is produced by callback chunk by chunk
+    /// \param next_chunk - callable returning std::string_view with next chunk; empty chunk means the end of text
+    /// \param on_entering - callable that receives index of pattern entering in the whole text as soon as it is found
+    template <typename ChunkSource, typename Callback>
+    void FeedFromSource(ChunkSource &&next_chunk, Callback &&on_entering) {
+        for (std::string_view chunk = next_chunk(); !chunk.empty(); chunk = next_chunk()) {
+            Feed(chunk.data(), chunk.size(), on_entering);
+        }
+    }
+
+    /// \brief Forgets processed text, so that matcher may be used for another one
+    void Reset() {
+        border_length_ = 0;
+        processed_quantity_ = 0;
+    }
+
+    /// \return Quantity of text characters that were processed since construction or last Reset
+    size_t GetProcessedQuantity() const {
+        return processed_quantity_;
+    }
+
+    /// \return Pattern matcher is searching for
+    const std::string &GetPattern() const {
+        return pattern_;
+    }
+
+private:
+    //-----------------------------------Variables-------------------------------------
+    std::string pattern_;
+    std::vector<size_t> prefixes_;
+    size_t border_length_;
+    size_t processed_quantity_;
+};
+
+/*! \class MultiPatternMatcher
+    \brief Aho-Corasick automaton finding enterings of several patterns during one pass over text
+
+    \param patterns_sizes_ - sizes of patterns, pattern is identified by its index in constructor argument
+    \param symbols_ids_ - maps byte to its index in compressed alphabet; 0 is used for bytes absent in all patterns
+    \param alphabet_size_ - quantity of symbols in compressed alphabet (including 0)
+    \param is_dense_ - whether transitions_ stores complete transition table or only trie edges
+    \param transitions_ - dense layout: transitions_[state * alphabet_size_ + symbol] is the next state
+    \param edges_begins_ - sparse layout: edges of state are in [edges_begins_[state], edges_begins_[state + 1])
+    \param edges_symbols_ - sparse layout: symbols of trie edges, sorted inside every state
+    \param edges_targets_ - sparse layout: states trie edges lead to
+    \param failures_ - sparse layout: state of the longest proper suffix of current state that is in trie
+    \param first_outputs_ - index of some pattern ending in state or kNoPattern
+    \param next_outputs_ - next pattern equal to the given one or kNoPattern (for repeated patterns)
+    \param dictionary_links_ - nearest state by failure links having outputs, or kNoState
+
+    Alphabet is compressed to bytes that occur in patterns. If it is small, complete transition table is built and
+    text is scanned with one table lookup per byte. Otherwise trie edges are kept in one sorted array per state and
+    failure links are followed, which keeps automaton size proportional to total patterns length.
+*/
+class MultiPatternMatcher {
+public:
+    static constexpr size_t kDefaultDenseAlphabetLimit = 64;
+
+    /// \param patterns - reference to vector with non-empty patterns
+    /// \param dense_alphabet_limit - the largest compressed alphabet size for which dense table is built
+    explicit MultiPatternMatcher(const std::vector<std::string> &patterns,
+                                 size_t dense_alphabet_limit = kDefaultDenseAlphabetLimit)
+        : patterns_sizes_(patterns.size()), symbols_ids_(), alphabet_size_(1), is_dense_(false) {
+        symbols_ids_.fill(0);
+        for (const std::string &pattern : patterns) {
+            assert(!pattern.empty());
+
+            for (char symbol : pattern) {
+                uint32_t &symbol_id = symbols_ids_[static_cast<unsigned char>(symbol)];
+                if (symbol_id == 0) {
+                    symbol_id = alphabet_size_++;
+                }
+            }
+        }
+        is_dense_ = alphabet_size_ <= dense_alphabet_limit;
+
+        std::vector<std::vector<std::pair<uint32_t, uint32_t>>> trie = BuildTrie(patterns);
+        if (is_dense_) {
+            BuildDenseTransitions(trie);
+        } else {
+            BuildSparseTransitions(trie);
+        }
+    }
+
+    /// \brief Finds enterings of all patterns in text
+    /// \param text - text where patterns are being searched
+    /// \param on_entering - callable that receives pattern index and index of its entering in text;
+    ///                      enterings are reported in order of their ends
+    template <typename Callback>
+    void Search(std::string_view text, Callback &&on_entering) const {
+        uint32_t state = kRoot;
+        for (size_t text_index = 0; text_index < text.size(); ++text_index) {
+            uint32_t symbol = symbols_ids_[static_cast<unsigned char>(text[text_index])];
+            state = is_dense_ ? transitions_[state * alphabet_size_ + symbol] : GetSparseTransition(state, symbol);
+
+            uint32_t output_state = first_outputs_[state] == kNoPattern ? dictionary_links_[state] : state;
+            while (output_state != kNoState) {
+                for (uint32_t pattern_index = first_outputs_[output_state]; pattern_index != kNoPattern;
+                     pattern_index = next_outputs_[pattern_index]) {
+                    on_entering(static_cast<size_t>(pattern_index), text_index + 1 - patterns_sizes_[pattern_index]);
+                }
+                output_state = dictionary_links_[output_state];
+            }
+        }
+    }
+
+    /// \brief Finds enterings of all patterns in text
+    /// \param text - text where patterns are being searched
+    /// \return std::vector with pairs (pattern index, index of entering in text) in order of enterings ends
+    std::vector<std::pair<size_t, size_t>> Search(std::string_view text) const {
+        std::vector<std::pair<size_t, size_t>> enterings{};
+        Search(text, [&](size_t pattern_index, size_t beginning) { enterings.emplace_back(pattern_index, beginning); });
+
+        return enterings;
+    }
+
+    /// \brief Finds enterings of all patterns in text grouping them by pattern
+    /// \param text - text where patterns are being searched
+    /// \return std::vector where i-th element is the same as Kmp(text, patterns[i]) returns
+    std::vector<std::vector<size_t>> SearchByPatterns(std::string_view text) const {
+        std::vector<std::vector<size_t>> beginnings(patterns_sizes_.size());
+        Search(text, [&](size_t pattern_index, size_t beginning) { beginnings[pattern_index].push_back(beginning); });
+
+        return beginnings;
+    }
+
+private:
+    static constexpr uint32_t kRoot = 0;
+    static constexpr uint32_t kNoState = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t kNoPattern = std::numeric_limits<uint32_t>::max();
+
+    /// \brief Builds trie of patterns and fills outputs
+    /// \param patterns - reference to vector with patterns
+    /// \return Trie where each state has edges (symbol, state) sorted by symbol
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> BuildTrie(const std::vector<std::string> &patterns) {
+        std::vector<std::vector<std::pair<uint32_t, uint32_t>>> trie(1);
+        first_outputs_.assign(1, kNoPattern);
+        next_outputs_.assign(patterns.size(), kNoPattern);
+        for (size_t pattern_index = 0; pattern_index < patterns.size(); ++pattern_index) {
+            const std::string &pattern = patterns[pattern_index];
+            patterns_sizes_[pattern_index] = pattern.size();
+
+            uint32_t state = kRoot;
+            for (char symbol : pattern) {
+                uint32_t symbol_id = symbols_ids_[static_cast<unsigned char>(symbol)];
+                auto &edges = trie[state];
+                auto edge_iterator = std::lower_bound(edges.begin(), edges.end(), std::make_pair(symbol_id, kRoot));
+                if ((edge_iterator != edges.end()) && (edge_iterator->first == symbol_id)) {
+                    state = edge_iterator->second;
+                } else {
+                    uint32_t new_state = static_cast<uint32_t>(trie.size());
+                    edges.insert(edge_iterator, {symbol_id, new_state});
+                    trie.emplace_back();
+                    first_outputs_.push_back(kNoPattern);
+                    state = new_state;
+                }
+            }
+
+            next_outputs_[pattern_index] = first_outputs_[state];
+            first_outputs_[state] = static_cast<uint32_t>(pattern_index);
+        }
+
+        return trie;
+    }
+
+    /// \brief Builds complete transition table in breadth-first order of trie
+    /// \param trie - reference to trie built by BuildTrie
+    void BuildDenseTransitions(const std::vector<std::vector<std::pair<uint32_t, uint32_t>>> &trie) {
+        size_t states_quantity = trie.size();
+        transitions_.assign(states_quantity * alphabet_size_, kRoot);
+        dictionary_links_.assign(states_quantity, kNoState);
+        std::vector<uint32_t> failures(states_quantity, kRoot);
+
+        std::queue<uint32_t> states_queue;
+        states_queue.push(kRoot);
+        while (!states_queue.empty()) {
+            uint32_t state = states_queue.front();
+            states_queue.pop();
+
+            uint32_t *state_transitions = transitions_.data() + state * alphabet_size_;
+            const uint32_t *failure_transitions = transitions_.data() + failures[state] * alphabet_size_;
+            if (state != kRoot) {
+                std::copy(failure_transitions, failure_transitions + alphabet_size_, state_transitions);
+            }
+            for (const auto &[symbol_id, child] : trie[state]) {
+                uint32_t child_failure = state == kRoot ? kRoot : failure_transitions[symbol_id];
+                failures[child] = child_failure;
+                dictionary_links_[child] =
+                    first_outputs_[child_failure] != kNoPattern ? child_failure : dictionary_links_[child_failure];
+                state_transitions[symbol_id] = child;
+                states_queue.push(child);
+            }
+        }
+    }
+
+    /// \brief Packs trie edges into sorted arrays and calculates failure links in breadth-first order of trie
+    /// \param trie - reference to trie built by BuildTrie
+    void BuildSparseTransitions(const std::vector<std::vector<std::pair<uint32_t, uint32_t>>> &trie) {
+        size_t states_quantity = trie.size();
+        edges_begins_.assign(states_quantity + 1, 0);
+        for (size_t state = 0; state < states_quantity; ++state) {
+            edges_begins_[state + 1] = edges_begins_[state] + static_cast<uint32_t>(trie[state].size());
+        }
+        edges_symbols_.resize(edges_begins_.back());
+        edges_targets_.resize(edges_begins_.back());
+        for (size_t state = 0; state < states_quantity; ++state) {
+            uint32_t edge_index = edges_begins_[state];
+            for (const auto &[symbol_id, child] : trie[state]) {
+                edges_symbols_[edge_index] = symbol_id;
+                edges_targets_[edge_index] = child;
+                ++edge_index;
+            }
+        }
+
+        failures_.assign(states_quantity, kRoot);
+        dictionary_links_.assign(states_quantity, kNoState);
+        std::queue<uint32_t> states_queue;
+        states_queue.push(kRoot);
+        while (!states_queue.empty()) {
+            uint32_t state = states_queue.front();
+            states_queue.pop();
+
+            for (const auto &[symbol_id, child] : trie[state]) {
+                uint32_t child_failure = state == kRoot ? kRoot : GetSparseTransition(failures_[state], symbol_id);
+                failures_[child] = child_failure;
+                dictionary_links_[child] =
+                    first_outputs_[child_failure] != kNoPattern ? child_failure : dictionary_links_[child_failure];
+                states_queue.push(child);
+            }
+        }
+    }
+
+    /// \brief Makes transition in sparse layout following failure links when there is no trie edge
+    /// \param state - current state
+    /// \param symbol_id - index of symbol in compressed alphabet
+    /// \return Next state
+    uint32_t GetSparseTransition(uint32_t state, uint32_t symbol_id) const {
+        while (true) {
+            auto edges_begin = edges_symbols_.cbegin() + edges_begins_[state];
+            auto edges_end = edges_symbols_.cbegin() + edges_begins_[state + 1];
+            auto edge_iterator = std::lower_bound(edges_begin, edges_end, symbol_id);
+            if ((edge_iterator != edges_end) && (*edge_iterator == symbol_id)) {
+                return edges_targets_[static_cast<size_t>(edge_iterator - edges_symbols_.cbegin())];
+            }
+            if (state == kRoot) {
+                return kRoot;
+            }
+            state = failures_[state];
+        }
+    }
+
+    //-----------------------------------Variables-------------------------------------
+    std::vector<size_t> patterns_sizes_;
+    std::array<uint32_t, 256> symbols_ids_;
+    uint32_t alphabet_size_;
+    bool is_dense_;
+
+    std::vector<uint32_t> transitions_;
+
+    std::vector<uint32_t> edges_begins_;
+    std::vector<uint32_t> edges_symbols_;
+    std::vector<uint32_t> edges_targets_;
+    std::vector<uint32_t> failures_;
+
+    std::vector<uint32_t> first_outputs_;
+    std::vector<uint32_t> next_outputs_;
+    std::vector<uint32_t> dictionary_links_;
+};
+
+/*! \struct ParallelKmpOptions
+    \brief Settings of ParallelKmp
+
+    \param threads_quantity - quantity of threads searching at once; 0 means std::thread::hardware_concurrency()
+    \param chunk_size - quantity of positions where entering may begin processed by one thread at a time
+*/
+struct ParallelKmpOptions {
+    size_t threads_quantity = 0;
+    size_t chunk_size = static_cast<size_t>(1) << 20;
+};
+
+/// \brief Knuth-Morris-Pratt algorithm running on several threads
+/// \param text - string where pattern is being searched
+/// \param pattern - string that is being searched in text
+/// \param options - reference to threads quantity and chunk size settings
+/// \return std::vector<size_t> with indexes of pattern enterings in text (the same as Kmp returns)
+///
+/// Text is split into chunks of beginnings, each one is scanned together with the next |pattern| - 1 characters.
+/// Entering belongs to the chunk containing its beginning, so per-chunk results neither intersect nor lose
+/// enterings on chunks borders, and concatenating them in chunks order gives sorted result.
+///
+inline std::vector<size_t> ParallelKmp(std::string_view text, std::string_view pattern,
+                                       const ParallelKmpOptions &options = {}) {
+    size_t text_size = text.size();
+    size_t pattern_size = pattern.size();
+    if ((pattern_size == 0) || (pattern_size > text_size)) {
+        return pattern_size == 0 ? Kmp(text, pattern) : std::vector<size_t>{};
+    }
+
+    size_t beginnings_quantity = text_size - pattern_size + 1;
+    size_t chunk_size = std::max<size_t>(options.chunk_size, 1);
+    size_t chunks_quantity = (beginnings_quantity + chunk_size - 1) / chunk_size;
+    size_t threads_quantity = options.threads_quantity;
+    if (threads_quantity == 0) {
+        threads_quantity = std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+    }
+    threads_quantity = std::min(threads_quantity, chunks_quantity);
+
+    const StreamingKmpMatcher prototype_matcher{std::string(pattern)};
+    std::vector<std::vector<size_t>> chunks_beginnings(chunks_quantity);
+    std::atomic<size_t> next_chunk{0};
+    auto search_chunks = [&]() {
+        StreamingKmpMatcher matcher = prototype_matcher;
+        for (size_t chunk = next_chunk++; chunk < chunks_quantity; chunk = next_chunk++) {
+            size_t chunk_begin = chunk * chunk_size;
+            size_t chunk_end = std::min(chunk_begin + chunk_size, beginnings_quantity);
+            std::vector<size_t> &beginnings = chunks_beginnings[chunk];
+
+            matcher.Reset();
+            matcher.Feed(text.data() + chunk_begin, chunk_end - chunk_begin + pattern_size - 1,
+                         [&](size_t beginning) { beginnings.push_back(chunk_begin + beginning); });
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threads_quantity - 1);
+    for (size_t thread_index = 1; thread_index < threads_quantity; ++thread_index) {
+        threads.emplace_back(search_chunks);
+    }
+    search_chunks();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    size_t beginnings_total = 0;
+    for (const std::vector<size_t> &beginnings : chunks_beginnings) {
+        beginnings_total += beginnings.size();
+    }
+    std::vector<size_t> beginnings{};
+    beginnings.reserve(beginnings_total);
+    for (const std::vector<size_t> &chunk_beginnings : chunks_beginnings) {
+        beginnings.insert(beginnings.end(), chunk_beginnings.cbegin(), chunk_beginnings.cend());
+    }
+
+    return beginnings;
+}
@@ -0,0 +1,328 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "prefix_function.h"
+
+/// \brief Finds how word can be separated into prefixes of text and appends the result to vector
+/// \param prefixes_begin - iterator to the beginning of part(!) of prefix function of string text#word,
+///                         where # is a sentinel (as CalculateConcatenationPrefixes(text, word) returns)
+/// \param prefixes_end - iterator to the end of the same part of prefix function
+/// \param prefixes_beginnings - vector indexes of prefixes of text to which word is separated are appended to
+/// \return Whether separation is possible; if it is not, prefixes_beginnings is left unchanged
+template <typename PrefixesIterator>
+bool AppendSeparationOfWordIntoTextPrefixes(PrefixesIterator prefixes_begin, PrefixesIterator prefixes_end,
+                                            std::vector<size_t> &prefixes_beginnings) {
+    if ((prefixes_begin == prefixes_end) || (*prefixes_begin == 0)) {
+        return false;
+    }
+
+    size_t initial_size = prefixes_beginnings.size();
+    auto prefixes_iterator = prefixes_end - 1;
+    while (prefixes_iterator != prefixes_begin) {
+        if (*prefixes_iterator == 0) {
+            prefixes_beginnings.resize(initial_size);
+
+            return false;
+        }
+
+        if (*(prefixes_iterator - 1) >= *prefixes_iterator) {
+            prefixes_beginnings.push_back(prefixes_iterator - prefixes_begin + 1 - *prefixes_iterator);
+        }
+
+        --prefixes_iterator;
+    }
+
+    prefixes_beginnings.push_back(0);
+
+    std::reverse(prefixes_beginnings.begin() + static_cast<std::vector<size_t>::difference_type>(initial_size),
+                 prefixes_beginnings.end());
+
+    return true;
+}
+
+/// \brief Finds how word can be separated into prefixes of text
+/// \param prefixes - reference to part(!) of prefix function of string text#word, where # is a sentinel
+///                   (as CalculateConcatenationPrefixes(text, word) returns)
+/// \return If separation is possible, std::vector<size_t> with indexes of prefixes of text to which word is separated;
+///         otherwise, std::nullopt is returned
+template <typename IndexType>
+std::optional<std::vector<size_t>> FindSeparationOfWordIntoTextPrefixes(const std::vector<IndexType> &prefixes) {
+    std::vector<size_t> prefixes_beginnings;
+    if (!AppendSeparationOfWordIntoTextPrefixes(prefixes.cbegin(), prefixes.cend(), prefixes_beginnings)) {
+        return std::nullopt;
+    }
+
+    return prefixes_beginnings;
+}
+
+/// \brief Gets prefixes of text to which word is separated without copying them
+/// \param word - word which is separated
+/// \param prefixes_beginnings - vector which contains indexes of prefixes of text to which word is separated
+/// \return std::vector<std::string_view> with pieces pointing into word, in the order they are printed
+inline std::vector<std::string_view> GetSeparationOfWordIntoTextPrefixes(
+    std::string_view word, const std::vector<size_t> &prefixes_beginnings) {
+    std::vector<std::string_view> pieces;
+    size_t prefixes_beginnings_size = prefixes_beginnings.size();
+    pieces.reserve(prefixes_beginnings_size);
+    if (prefixes_beginnings_size == 1) {
+        pieces.push_back(word);
+    } else {
+        auto prefixes_beginnings_iterator = prefixes_beginnings.cbegin() + 1;
+        auto prefixes_beginnings_end = prefixes_beginnings.cend();
+        while (prefixes_beginnings_iterator != prefixes_beginnings_end) {
+            size_t delta = *prefixes_beginnings_iterator - *(prefixes_beginnings_iterator - 1);
+
+            pieces.push_back(word.substr(*(prefixes_beginnings_iterator - 1), delta));
+
+            ++prefixes_beginnings_iterator;
+        }
+
+        pieces.push_back(word.substr(*(prefixes_beginnings_end - 1)));
+    }
+
+    return pieces;
+}
+
+/// \brief Finds how word can be separated into prefixes of text storing prefix function values as IndexType
+/// \param text - text prefixes of which are used
+/// \param word - word that is being separated
+/// \return The same as FindSeparationOfWordIntoTextPrefixes
+template <typename IndexType>
+std::optional<std::vector<size_t>> SeparateWordIntoTextPrefixes(std::string_view text, std::string_view word) {
+    std::vector<IndexType> prefixes_for_word = CalculateConcatenationPrefixes<IndexType>(text, word);
+
+    return FindSeparationOfWordIntoTextPrefixes(prefixes_for_word);
+}
+
+/*! \class OnlineWordSeparator
+    \brief Decides whether word received byte by byte can be separated into prefixes of text
+
+    \param text_ - text prefixes of which are used
+    \param text_prefixes_ - prefix function of text_
+    \param border_length_ - length of the longest suffix of received part of word that is prefix of text_
+    \param is_separable_ - whether received part of word can be separated into prefixes of text_
+    \param received_quantity_ - quantity of received bytes of word
+
+    Word can be separated iff every its position is the end of some non-empty prefix of text found in word, that is
+    border_length_ never becomes 0. Each received byte costs O(1) amortised, memory depends only on text size.
+*/
+template <typename IndexType = size_t>
+class OnlineWordSeparator {
+public:
+    explicit OnlineWordSeparator(std::string text)
+        : text_(std::move(text)), text_prefixes_(), border_length_(0), is_separable_(true), received_quantity_(0) {
+        if (!text_.empty()) {
+            text_prefixes_ = CalculatePrefixes<IndexType>(text_);
+        }
+    }
+
+    /// \brief Receives next byte of word
+    /// \param symbol - received byte
+    /// \return Whether received part of word can be separated into prefixes of text
+    bool Push(char symbol) {
+        ++received_quantity_;
+        if (!is_separable_) {
+            return false;
+        }
+        if (text_.empty()) {
+            is_separable_ = false;
+
+            return false;
+        }
+
+        border_length_ = AdvanceBorder(text_, text_prefixes_.data(), border_length_, symbol);
+        is_separable_ = border_length_ != 0;
+
+        return is_separable_;
+    }
+
+    /// \brief Receives next bytes of word
+    /// \param chunk - received bytes
+    /// \return Whether received part of word can be separated into prefixes of text
+    bool Push(std::string_view chunk) {
+        for (char symbol : chunk) {
+            Push(symbol);
+        }
+
+        return is_separable_;
+    }
+
+    /// \return Whether received part of word can be separated into prefixes of text
+    bool IsSeparable() const {
+        return is_separable_;
+    }
+
+    /// \return Length of the longest prefix of text received part of word ends with (0 if it is not separable)
+    size_t GetLastPrefixLength() const {
+        return is_separable_ ? static_cast<size_t>(border_length_) : 0;
+    }
+
+    /// \return Quantity of bytes of word received since construction or last Reset
+    size_t GetReceivedQuantity() const {
+        return received_quantity_;
+    }
+
+    /// \brief Forgets received word, so that the next one may be received
+    void Reset() {
+        border_length_ = 0;
+        is_separable_ = true;
+        received_quantity_ = 0;
+    }
+
+private:
+    //-----------------------------------Variables-------------------------------------
+    std::string text_;
+    std::vector<IndexType> text_prefixes_;
+    IndexType border_length_;
+    bool is_separable_;
+    size_t received_quantity_;
+};
+
+/*! \struct WordsSeparations
+    \brief Separations of batch of words into prefixes of text packed in one buffer
+
+    \param prefixes_beginnings - indexes of prefixes beginnings (as FindSeparationOfWordIntoTextPrefixes returns)
+                                 of all separable words one after another
+    \param separations_offsets - separation of i-th word occupies
+                                 [separations_offsets[i], separations_offsets[i + 1]) of prefixes_beginnings
+    \param are_separable - whether i-th word can be separated (its range is empty otherwise)
+*/
+struct WordsSeparations {
+    std::vector<size_t> prefixes_beginnings;
+    std::vector<size_t> separations_offsets;
+    std::vector<uint8_t> are_separable;
+};
+
+/*! \class PreparedText
+    \brief Text with precalculated prefix function that separates many words into its prefixes
+
+    \param text_ - text prefixes of which are used
+    \param text_prefixes_ - prefix function of text_
+
+    Prefix function of text is calculated once, then each word costs O(|word|). Batch of words is separated by
+    several threads taking blocks of words one by one; scratch prefix function buffer is reused inside a thread.
+*/
+template <typename IndexType = size_t>
+class PreparedText {
+public:
+    static constexpr size_t kWordsBlockSize = 1024;
+
+    explicit PreparedText(std::string text) : text_(std::move(text)), text_prefixes_() {
+        if (!text_.empty()) {
+            text_prefixes_ = CalculatePrefixes<IndexType>(text_);
+        }
+    }
+
+    /// \brief Finds how word can be separated into prefixes of text
+    /// \param word - word that is being separated
+    /// \return The same as FindSeparationOfWordIntoTextPrefixes
+    std::optional<std::vector<size_t>> Separate(std::string_view word) const {
+        std::vector<IndexType> word_prefixes;
+        std::vector<size_t> prefixes_beginnings;
+        if (!CalculateWordPrefixes(word, word_prefixes) ||
+            !AppendSeparationOfWordIntoTextPrefixes(word_prefixes.cbegin(), word_prefixes.cend(),
+                                                    prefixes_beginnings)) {
+            return std::nullopt;
+        }
+
+        return prefixes_beginnings;
+    }
+
+    /// \brief Finds how each of words can be separated into prefixes of text
+    /// \param words - reference to container with words (std::string or std::string_view)
+    /// \param threads_quantity - quantity of threads; 0 means std::thread::hardware_concurrency()
+    /// \return WordsSeparations with separations of all words
+    template <typename WordsContainer>
+    WordsSeparations SeparateBatch(const WordsContainer &words, size_t threads_quantity = 0) const {
+        size_t words_quantity = words.size();
+        size_t blocks_quantity = (words_quantity + kWordsBlockSize - 1) / kWordsBlockSize;
+        if (threads_quantity == 0) {
+            threads_quantity = std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+        }
+        threads_quantity = std::max<size_t>(std::min(threads_quantity, blocks_quantity), 1);
+
+        WordsSeparations separations{};
+        separations.separations_offsets.assign(words_quantity + 1, 0);
+        separations.are_separable.assign(words_quantity, 0);
+
+        // each word stores the size of its separation in separations_offsets[word + 1] until prefix sums are taken
+        std::vector<std::vector<size_t>> blocks_prefixes_beginnings(blocks_quantity);
+        std::atomic<size_t> next_block{0};
+        auto separate_blocks = [&]() {
+            std::vector<IndexType> word_prefixes;
+            for (size_t block = next_block++; block < blocks_quantity; block = next_block++) {
+                size_t block_begin = block * kWordsBlockSize;
+                size_t block_end = std::min(block_begin + kWordsBlockSize, words_quantity);
+                std::vector<size_t> &prefixes_beginnings = blocks_prefixes_beginnings[block];
+                for (size_t word_index = block_begin; word_index < block_end; ++word_index) {
+                    size_t initial_size = prefixes_beginnings.size();
+                    if (CalculateWordPrefixes(words[word_index], word_prefixes) &&
+                        AppendSeparationOfWordIntoTextPrefixes(word_prefixes.cbegin(), word_prefixes.cend(),
+                                                               prefixes_beginnings)) {
+                        separations.are_separable[word_index] = 1;
+                        separations.separations_offsets[word_index + 1] = prefixes_beginnings.size() - initial_size;
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(threads_quantity - 1);
+        for (size_t thread_index = 1; thread_index < threads_quantity; ++thread_index) {
+            threads.emplace_back(separate_blocks);
+        }
+        separate_blocks();
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        for (size_t word_index = 0; word_index < words_quantity; ++word_index) {
+            separations.separations_offsets[word_index + 1] += separations.separations_offsets[word_index];
+        }
+        separations.prefixes_beginnings.reserve(separations.separations_offsets.back());
+        for (const std::vector<size_t> &prefixes_beginnings : blocks_prefixes_beginnings) {
+            separations.prefixes_beginnings.insert(separations.prefixes_beginnings.end(),
+                                                   prefixes_beginnings.cbegin(), prefixes_beginnings.cend());
+        }
+
+        return separations;
+    }
+
+private:
+    /// \brief Calculates part of prefix function of text#word for word (# is a sentinel)
+    /// \param word - word that is being separated
+    /// \param word_prefixes - vector the result is written to
+    /// \return false if some value is 0 (calculation stops there, since word can not be separated then)
+    bool CalculateWordPrefixes(std::string_view word, std::vector<IndexType> &word_prefixes) const {
+        word_prefixes.clear();
+        if (text_.empty()) {
+            return false;
+        }
+
+        IndexType border_length = 0;
+        for (char symbol : word) {
+            border_length = AdvanceBorder(text_, text_prefixes_.data(), border_length, symbol);
+            if (border_length == 0) {
+                return false;
+            }
+
+            word_prefixes.push_back(border_length);
+        }
+
+        return true;
+    }
+
+    //-----------------------------------Variables-------------------------------------
+    std::string text_;
+    std::vector<IndexType> text_prefixes_;
+};
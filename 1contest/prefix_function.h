@@ -0,0 +1,79 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+/// \brief Moves Knuth-Morris-Pratt automaton of pattern by one byte of text
+/// \param pattern - string prefixes of which are matched, not empty
+/// \param prefixes - pointer to prefix function of pattern (at least its first border_length values)
+/// \param border_length - length of the longest suffix of processed text that is prefix of pattern
+/// \param symbol - next byte of text
+/// \return The same length for processed text with symbol appended
+///
+/// Border equal to the whole pattern is shortened by prefix function first, so enterings may overlap.
+///
+template <typename IndexType>
+inline IndexType AdvanceBorder(std::string_view pattern, const IndexType *prefixes, IndexType border_length,
+                               char symbol) {
+    if (static_cast<size_t>(border_length) == pattern.size()) {
+        border_length = prefixes[static_cast<size_t>(border_length) - 1];
+    }
+    while ((border_length > 0) && (symbol != pattern[static_cast<size_t>(border_length)])) {
+        border_length = prefixes[static_cast<size_t>(border_length) - 1];
+    }
+    if (symbol == pattern[static_cast<size_t>(border_length)]) {
+        ++border_length;
+    }
+
+    return border_length;
+}
+
+/// \brief Calculates value of prefix function
+/// \param str - string prefix function is being calculated of
+/// \param allocator - allocator of the result
+/// \return std::vector<IndexType> with prefix function values
+///
+/// IndexType should be able to hold str.size(); uint32_t halves memory comparing to size_t for strings under 4 GiB
+///
+template <typename IndexType = size_t, typename Allocator = std::allocator<IndexType>>
+std::vector<IndexType, Allocator> CalculatePrefixes(std::string_view str, const Allocator &allocator = Allocator()) {
+    size_t str_size = str.size();
+    std::vector<IndexType, Allocator> prefixes(str_size, 0, allocator);
+    for (size_t i = 1; i < str_size; ++i) {
+        prefixes[i] = AdvanceBorder(str, prefixes.data(), prefixes[i - 1], str[i]);
+    }
+
+    return prefixes;
+}
+
+/// \brief Calculates value of prefix function of first + sentinel + second for the second part only
+/// \param first - string that goes before sentinel
+/// \param second - string that goes after sentinel
+/// \param allocator - allocator of the result
+/// \return std::vector<IndexType> where i-th value is prefix function of concatenation at position of second[i]
+///
+/// Sentinel is a logical symbol that is not equal to any byte, so strings may contain every byte value.
+/// Concatenation is never built: borders longer than first are impossible, and borders equal to first are shortened
+/// by prefix function of first before comparing with the next byte of second.
+///
+template <typename IndexType = size_t, typename Allocator = std::allocator<IndexType>>
+std::vector<IndexType, Allocator> CalculateConcatenationPrefixes(std::string_view first, std::string_view second,
+                                                                 const Allocator &allocator = Allocator()) {
+    std::vector<IndexType, Allocator> prefixes(second.size(), 0, allocator);
+    if (first.empty()) {
+        return prefixes;
+    }
+
+    std::vector<IndexType, Allocator> first_prefixes = CalculatePrefixes<IndexType>(first, allocator);
+    auto prefixes_iterator = prefixes.begin();
+    IndexType border_length = 0;
+    for (char symbol : second) {
+        border_length = AdvanceBorder(first, first_prefixes.data(), border_length, symbol);
+        *prefixes_iterator = border_length;
+
+        ++prefixes_iterator;
+    }
+
+    return prefixes;
+}
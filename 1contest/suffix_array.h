@@ -0,0 +1,760 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../common/thread_pool.h"
+
+/*! \class SuffixContext
+    \brief Information about suffixes of given string
+
+    initial_index - index where suffix starts in string
+    rank - helper index indicating the order in which first parts of suffixes are sorted
+    next_rank - helper index indicating the order in which second parts of suffixes are sorted
+*/
+struct SuffixContext {
+    int initial_index = 0;
+    int rank = 0;
+    int next_rank = 0;
+};
+
+/// \brief Compares two suffixes according to their rank and next rank
+/// \param suf1 - reference to first  SuffixContext
+/// \param suf2 - reference to second SuffixContext
+/// \return true if suf1 strictly lexicographically smaller than suf2; false otherwise
+inline bool Comparator(const SuffixContext &suf1, const SuffixContext &suf2) {
+    return suf1.rank < suf2.rank ? true : suf1.rank == suf2.rank ? suf1.next_rank < suf2.next_rank : false;
+}
+
+/// \brief Builds suffix array of given string by prefix doubling with comparison sort, O(n log^2 n)
+/// \param str - given string
+/// \return std::vector<int> - suffix array where each suffix is represented by index where it starts in str (beginning with 1)
+inline std::vector<int> BuildSufArrByPrefixDoubling(std::string_view str) {
+    int str_size = static_cast<int>(str.size());
+    std::vector<SuffixContext> suffixes(str_size);
+    auto suffixes_begin = suffixes.begin();
+    auto suffixes_end = suffixes.cend();
+    auto suffixes_iterator = suffixes_begin;
+    while (suffixes_iterator != suffixes_end) {
+        int suffix_index = static_cast<int>(suffixes_iterator - suffixes_begin);
+        suffixes_iterator->initial_index = suffix_index;
+        auto str_iterator = str.cbegin() + static_cast<std::string_view::difference_type>(suffix_index);
+        suffixes_iterator->rank = *str_iterator;
+        suffixes_iterator->next_rank = suffix_index == str_size - 1 ? -1 : *(str_iterator + 1);
+
+        ++suffixes_iterator;
+    }
+
+    std::sort(suffixes.begin(), suffixes.end(), Comparator);
+
+    for (int sorted_length = 2; sorted_length < str_size; sorted_length *= 2) {
+        int prev_rank = suffixes_begin->rank;
+        suffixes_begin->rank = 0;
+
+        std::vector<int> intermediary_order(str_size);
+        auto intermediary_order_begin = intermediary_order.begin();
+        auto intermediary_order_iterator =
+            intermediary_order_begin + static_cast<std::vector<int>::difference_type>(suffixes_begin->initial_index);
+        *intermediary_order_iterator = 0;
+        int cur_rank = 0;
+        suffixes_iterator = suffixes_begin + 1;
+        while (suffixes_iterator != suffixes_end) {
+            bool equal_to_prev = false;
+
+            if ((suffixes_iterator->rank == prev_rank) &&
+                (suffixes_iterator->next_rank == (suffixes_iterator - 1)->next_rank)) {
+                equal_to_prev = true;
+            }
+
+            prev_rank = suffixes_iterator->rank;
+            if (!equal_to_prev) {
+                ++cur_rank;
+            }
+            suffixes_iterator->rank = cur_rank;
+
+            *(intermediary_order_begin +
+              static_cast<std::vector<int>::difference_type>(suffixes_iterator->initial_index)) =
+                static_cast<int>(suffixes_iterator - suffixes_begin);
+
+            ++suffixes_iterator;
+        }
+
+        suffixes_iterator = suffixes_begin;
+        while (suffixes_iterator != suffixes_end) {
+            int next_suffix_real_index = suffixes_iterator->initial_index + sorted_length;
+            suffixes_iterator->next_rank =
+                next_suffix_real_index >= str_size
+                    ? -1
+                    : (suffixes_begin + static_cast<std::vector<SuffixContext>::difference_type>(
+                                            *(intermediary_order_begin +
+                                              static_cast<std::vector<int>::difference_type>(next_suffix_real_index))))
+                          ->rank;
+
+            ++suffixes_iterator;
+        }
+
+        std::sort(suffixes.begin(), suffixes.end(), Comparator);
+    }
+
+    std::vector<int> result(str_size);
+    auto result_end = result.cend();
+    auto result_iterator = result.begin();
+    suffixes_iterator = suffixes_begin;
+    while (result_iterator != result_end) {
+        *result_iterator = suffixes_iterator->initial_index + 1;
+
+        ++result_iterator;
+        ++suffixes_iterator;
+    }
+
+    return result;
+}
+
+/// \brief Builds suffix array of given string by prefix doubling with radix sort, O(n log n)
+/// \param str - given string
+/// \return std::vector<int> - suffix array where each suffix is represented by index where it starts in str
+/// (beginning with 1)
+///
+/// Every round sorts suffixes by pair (rank, next_rank) in two passes: order by next_rank is taken from the previous
+/// round's order shifted by sorted_length, then counting sort by rank. All buffers are allocated once, rounds stop
+/// as soon as all ranks are unique.
+///
+inline std::vector<int> BuildSufArrByRadixDoubling(std::string_view str) {
+    size_t str_size = str.size();
+    if (str_size == 0) {
+        return {};
+    }
+
+    size_t ranks_quantity = std::numeric_limits<unsigned char>::max() + 2;
+    std::vector<size_t> suf_arr(str_size);
+    std::vector<size_t> ranks(str_size);
+    std::vector<size_t> next_ranks(str_size);
+    std::vector<size_t> intermediary_order(str_size);
+    std::vector<size_t> ranks_counts(std::max(ranks_quantity, str_size + 1));
+    for (size_t i = 0; i < str_size; ++i) {
+        ranks[i] = static_cast<size_t>(static_cast<int>(str[i]) - std::numeric_limits<char>::min() + 1);
+        intermediary_order[i] = i;
+    }
+
+    for (size_t sorted_length = 0;; sorted_length = std::max<size_t>(1, sorted_length * 2)) {
+        if (sorted_length > 0) {
+            size_t order_size = 0;
+            for (size_t i = str_size - std::min(str_size, sorted_length); i < str_size; ++i) {
+                intermediary_order[order_size++] = i;
+            }
+            for (size_t suffix : suf_arr) {
+                if (suffix >= sorted_length) {
+                    intermediary_order[order_size++] = suffix - sorted_length;
+                }
+            }
+        }
+
+        std::fill(ranks_counts.begin(), ranks_counts.begin() + static_cast<std::ptrdiff_t>(ranks_quantity), 0);
+        for (size_t i = 0; i < str_size; ++i) {
+            ++ranks_counts[ranks[i]];
+        }
+        for (size_t rank = 1; rank < ranks_quantity; ++rank) {
+            ranks_counts[rank] += ranks_counts[rank - 1];
+        }
+        for (size_t i = str_size; i-- > 0;) {
+            suf_arr[--ranks_counts[ranks[intermediary_order[i]]]] = intermediary_order[i];
+        }
+
+        auto get_next_rank = [&](size_t suffix) {
+            return (sorted_length > 0) && (suffix + sorted_length < str_size) ? ranks[suffix + sorted_length] : 0;
+        };
+        next_ranks[suf_arr[0]] = 1;
+        for (size_t i = 1; i < str_size; ++i) {
+            size_t prev = suf_arr[i - 1];
+            size_t cur = suf_arr[i];
+            bool equal_to_prev = (ranks[prev] == ranks[cur]) && (get_next_rank(prev) == get_next_rank(cur));
+            next_ranks[cur] = next_ranks[prev] + (equal_to_prev ? 0 : 1);
+        }
+        ranks.swap(next_ranks);
+
+        ranks_quantity = ranks[suf_arr[str_size - 1]] + 1;
+        if (ranks_quantity == str_size + 1) {
+            break;
+        }
+    }
+
+    std::vector<int> result(str_size);
+    for (size_t i = 0; i < str_size; ++i) {
+        result[i] = static_cast<int>(suf_arr[i] + 1);
+    }
+
+    return result;
+}
+
+/*! \struct ParallelSufArrOptions
+    \brief Settings of BuildSufArrInParallel
+
+    \param threads_quantity - quantity of threads building suffix array at once; 0 means
+    std::thread::hardware_concurrency()
+*/
+struct ParallelSufArrOptions {
+    size_t threads_quantity = 0;
+};
+
+/// \brief Builds suffix array of given string by prefix doubling running on several threads
+/// \param str - given string
+/// \param options - reference to threads quantity setting
+/// \return std::vector<int> - suffix array where each suffix is represented by index where it starts in str
+/// (beginning with 1), the same as serial algorithms return
+///
+/// Suffixes are split into one segment per thread, threads are started once and reused by every step. Every round
+/// (rank, next_rank) pairs are filled and segments are sorted in parallel, then sorted segments are merged pairwise
+/// in parallel. New ranks are assigned by prefix sums: each segment counts its rank changes, counts are accumulated,
+/// then each segment writes its ranks independently.
+///
+inline std::vector<int> BuildSufArrInParallel(std::string_view str, const ParallelSufArrOptions &options = {}) {
+    size_t str_size = str.size();
+    if (str_size == 0) {
+        return {};
+    }
+
+    size_t threads_quantity = options.threads_quantity;
+    if (threads_quantity == 0) {
+        threads_quantity = std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+    }
+    size_t segments_quantity = std::min(threads_quantity, str_size);
+    ThreadPool thread_pool(segments_quantity);
+    auto get_segment_begin = [&](size_t segment) { return str_size * segment / segments_quantity; };
+
+    std::vector<int> ranks(str_size);
+    std::vector<SuffixContext> suffixes(str_size);
+    std::vector<SuffixContext> merged_suffixes(str_size);
+    std::vector<int> segments_rank_changes(segments_quantity);
+    thread_pool.RunTasks(segments_quantity, [&](size_t segment) {
+        for (size_t i = get_segment_begin(segment); i < get_segment_begin(segment + 1); ++i) {
+            ranks[i] = static_cast<int>(str[i]) - std::numeric_limits<char>::min() + 1;
+            suffixes[i].initial_index = static_cast<int>(i);
+        }
+    });
+
+    for (size_t sorted_length = 1;; sorted_length *= 2) {
+        thread_pool.RunTasks(segments_quantity, [&](size_t segment) {
+            auto segment_begin = suffixes.begin() + static_cast<std::ptrdiff_t>(get_segment_begin(segment));
+            auto segment_end = suffixes.begin() + static_cast<std::ptrdiff_t>(get_segment_begin(segment + 1));
+            for (auto suffixes_iterator = segment_begin; suffixes_iterator != segment_end; ++suffixes_iterator) {
+                size_t suffix_index = static_cast<size_t>(suffixes_iterator->initial_index);
+                suffixes_iterator->rank = ranks[suffix_index];
+                suffixes_iterator->next_rank =
+                    suffix_index + sorted_length < str_size ? ranks[suffix_index + sorted_length] : 0;
+            }
+            std::sort(segment_begin, segment_end, Comparator);
+        });
+
+        for (size_t merged_width = 1; merged_width < segments_quantity; merged_width *= 2) {
+            size_t merges_quantity = (segments_quantity + 2 * merged_width - 1) / (2 * merged_width);
+            thread_pool.RunTasks(merges_quantity, [&](size_t merge) {
+                size_t first_segment = merge * 2 * merged_width;
+                size_t second_segment = std::min(first_segment + merged_width, segments_quantity);
+                size_t end_segment = std::min(first_segment + 2 * merged_width, segments_quantity);
+                auto first_begin = suffixes.cbegin() + static_cast<std::ptrdiff_t>(get_segment_begin(first_segment));
+                auto second_begin = suffixes.cbegin() + static_cast<std::ptrdiff_t>(get_segment_begin(second_segment));
+                auto second_end = suffixes.cbegin() + static_cast<std::ptrdiff_t>(get_segment_begin(end_segment));
+                std::merge(first_begin, second_begin, second_begin, second_end,
+                           merged_suffixes.begin() + (first_begin - suffixes.cbegin()), Comparator);
+            });
+            suffixes.swap(merged_suffixes);
+        }
+
+        auto is_rank_changed = [&](size_t i) {
+            return (i == 0) || (suffixes[i - 1].rank != suffixes[i].rank) ||
+                   (suffixes[i - 1].next_rank != suffixes[i].next_rank);
+        };
+        thread_pool.RunTasks(segments_quantity, [&](size_t segment) {
+            int rank_changes = 0;
+            for (size_t i = get_segment_begin(segment); i < get_segment_begin(segment + 1); ++i) {
+                rank_changes += is_rank_changed(i) ? 1 : 0;
+            }
+            segments_rank_changes[segment] = rank_changes;
+        });
+        int ranks_quantity = 0;
+        for (int &rank_changes : segments_rank_changes) {
+            int segment_rank_changes = rank_changes;
+            rank_changes = ranks_quantity;
+            ranks_quantity += segment_rank_changes;
+        }
+        thread_pool.RunTasks(segments_quantity, [&](size_t segment) {
+            int rank = segments_rank_changes[segment];
+            for (size_t i = get_segment_begin(segment); i < get_segment_begin(segment + 1); ++i) {
+                rank += is_rank_changed(i) ? 1 : 0;
+                ranks[static_cast<size_t>(suffixes[i].initial_index)] = rank;
+            }
+        });
+
+        if (static_cast<size_t>(ranks_quantity) == str_size) {
+            break;
+        }
+    }
+
+    std::vector<int> result(str_size);
+    thread_pool.RunTasks(segments_quantity, [&](size_t segment) {
+        for (size_t i = get_segment_begin(segment); i < get_segment_begin(segment + 1); ++i) {
+            result[i] = suffixes[i].initial_index + 1;
+        }
+    });
+
+    return result;
+}
+
+namespace compact_sais {
+/// Marks free cells of suffix array during construction
+template <typename IndexType>
+constexpr IndexType kEmpty = std::numeric_limits<IndexType>::max();
+
+/// Symbols of reduced string stored inside of suffix array
+template <typename IndexType>
+struct ReducedSymbols {
+    const IndexType *reduced_str;
+
+    IndexType operator()(IndexType i) const {
+        return reduced_str[i];
+    }
+};
+
+/// \brief Calculates beginnings or ends of buckets of symbols
+/// \param symbols - callable returning symbol by its index
+/// \param str_size - quantity of symbols
+/// \param max_symbol - the largest possible symbol
+/// \param buckets - reference to buckets that are filled
+/// \param ends - true to calculate ends of buckets, false to calculate beginnings
+template <typename IndexType, typename Symbols>
+void CalculateBuckets(const Symbols &symbols, IndexType str_size, IndexType max_symbol,
+                      std::vector<IndexType> &buckets, bool ends) {
+    buckets.assign(static_cast<size_t>(max_symbol) + 1, 0);
+    for (IndexType i = 0; i < str_size; ++i) {
+        ++buckets[symbols(i)];
+    }
+
+    IndexType sum = 0;
+    for (IndexType &bucket : buckets) {
+        sum += bucket;
+        bucket = ends ? sum : sum - bucket;
+    }
+}
+
+/// \brief Puts L-type suffixes to their places looking at already placed suffixes from left to right
+template <typename IndexType, typename Symbols>
+void InduceLTypes(const Symbols &symbols, const std::vector<bool> &is_s_type, IndexType *suf_arr, IndexType str_size,
+                  IndexType max_symbol, std::vector<IndexType> &buckets) {
+    CalculateBuckets(symbols, str_size, max_symbol, buckets, false);
+    for (IndexType i = 0; i < str_size; ++i) {
+        if ((suf_arr[i] != kEmpty<IndexType>) && (suf_arr[i] > 0) && (!is_s_type[suf_arr[i] - 1])) {
+            IndexType suffix = suf_arr[i] - 1;
+            suf_arr[buckets[symbols(suffix)]++] = suffix;
+        }
+    }
+}
+
+/// \brief Puts S-type suffixes to their places looking at already placed suffixes from right to left
+template <typename IndexType, typename Symbols>
+void InduceSTypes(const Symbols &symbols, const std::vector<bool> &is_s_type, IndexType *suf_arr, IndexType str_size,
+                  IndexType max_symbol, std::vector<IndexType> &buckets) {
+    CalculateBuckets(symbols, str_size, max_symbol, buckets, true);
+    for (IndexType i = str_size; i > 0; --i) {
+        if ((suf_arr[i - 1] != kEmpty<IndexType>) && (suf_arr[i - 1] > 0) && (is_s_type[suf_arr[i - 1] - 1])) {
+            IndexType suffix = suf_arr[i - 1] - 1;
+            suf_arr[--buckets[symbols(suffix)]] = suffix;
+        }
+    }
+}
+
+/// \brief SA-IS algorithm keeping reduced string and its suffix array inside of suf_arr
+/// \param symbols - callable returning symbol by its index, the last symbol must be unique and the smallest one
+/// \param suf_arr - pointer to str_size cells where suffix array is written (beginning with 0)
+/// \param str_size - quantity of symbols
+/// \param max_symbol - the largest possible symbol
+///
+/// Layout follows Nong, Zhang and Chan: types are kept in bitmap, sorted LMS substrings are compacted to the
+/// beginning of suf_arr, their names to the end, so recursion needs no memory except for types and buckets.
+///
+template <typename IndexType, typename Symbols>
+void BuildSufArrInPlace(const Symbols &symbols, IndexType *suf_arr, IndexType str_size, IndexType max_symbol) {
+    std::vector<bool> is_s_type(str_size, false);
+    is_s_type[str_size - 1] = true;
+    for (IndexType i = str_size - 1; i > 1; --i) {
+        IndexType symbol = symbols(i - 2);
+        IndexType next_symbol = symbols(i - 1);
+        is_s_type[i - 2] = (symbol < next_symbol) || ((symbol == next_symbol) && is_s_type[i - 1]);
+    }
+    auto is_lms = [&is_s_type](IndexType i) { return (i > 0) && is_s_type[i] && !is_s_type[i - 1]; };
+
+    std::vector<IndexType> buckets;
+    CalculateBuckets(symbols, str_size, max_symbol, buckets, true);
+    std::fill(suf_arr, suf_arr + str_size, kEmpty<IndexType>);
+    for (IndexType i = 1; i < str_size; ++i) {
+        if (is_lms(i)) {
+            suf_arr[--buckets[symbols(i)]] = i;
+        }
+    }
+    InduceLTypes(symbols, is_s_type, suf_arr, str_size, max_symbol, buckets);
+    InduceSTypes(symbols, is_s_type, suf_arr, str_size, max_symbol, buckets);
+
+    IndexType lms_quantity = 0;
+    for (IndexType i = 0; i < str_size; ++i) {
+        if (is_lms(suf_arr[i])) {
+            suf_arr[lms_quantity++] = suf_arr[i];
+        }
+    }
+
+    std::fill(suf_arr + lms_quantity, suf_arr + str_size, kEmpty<IndexType>);
+    IndexType names_quantity = 0;
+    IndexType prev = kEmpty<IndexType>;
+    for (IndexType i = 0; i < lms_quantity; ++i) {
+        IndexType position = suf_arr[i];
+        bool is_different = false;
+        for (IndexType offset = 0; offset < str_size; ++offset) {
+            if ((prev == kEmpty<IndexType>) || (symbols(position + offset) != symbols(prev + offset)) ||
+                (is_s_type[position + offset] != is_s_type[prev + offset])) {
+                is_different = true;
+                break;
+            }
+            if ((offset > 0) && (is_lms(position + offset) || is_lms(prev + offset))) {
+                break;
+            }
+        }
+
+        if (is_different) {
+            ++names_quantity;
+            prev = position;
+        }
+        suf_arr[lms_quantity + position / 2] = names_quantity - 1;
+    }
+    for (IndexType i = str_size, j = str_size; i > lms_quantity; --i) {
+        if (suf_arr[i - 1] != kEmpty<IndexType>) {
+            suf_arr[--j] = suf_arr[i - 1];
+        }
+    }
+
+    IndexType *reduced_suf_arr = suf_arr;
+    IndexType *reduced_str = suf_arr + str_size - lms_quantity;
+    if (names_quantity < lms_quantity) {
+        BuildSufArrInPlace(ReducedSymbols<IndexType>{reduced_str}, reduced_suf_arr, lms_quantity, names_quantity - 1);
+    } else {
+        for (IndexType i = 0; i < lms_quantity; ++i) {
+            reduced_suf_arr[reduced_str[i]] = i;
+        }
+    }
+
+    for (IndexType i = 1, j = 0; i < str_size; ++i) {
+        if (is_lms(i)) {
+            reduced_str[j++] = i;
+        }
+    }
+    for (IndexType i = 0; i < lms_quantity; ++i) {
+        reduced_suf_arr[i] = reduced_str[reduced_suf_arr[i]];
+    }
+    std::fill(suf_arr + lms_quantity, suf_arr + str_size, kEmpty<IndexType>);
+    CalculateBuckets(symbols, str_size, max_symbol, buckets, true);
+    for (IndexType i = lms_quantity; i > 0; --i) {
+        IndexType suffix = suf_arr[i - 1];
+        suf_arr[i - 1] = kEmpty<IndexType>;
+        suf_arr[--buckets[symbols(suffix)]] = suffix;
+    }
+    InduceLTypes(symbols, is_s_type, suf_arr, str_size, max_symbol, buckets);
+    InduceSTypes(symbols, is_s_type, suf_arr, str_size, max_symbol, buckets);
+}
+}  // namespace compact_sais
+
+/// \brief Builds suffix array of given string by SA-IS using about 5n bytes for 32-bit indexes
+/// \param str - given string, its size must be less than std::numeric_limits<IndexType>::max() - 1
+/// \return std::vector<IndexType> - suffix array where each suffix is represented by index where it starts in str
+/// (beginning with 1), the same as BuildSufArr returns
+///
+/// Virtual sentinel that is less than all characters is appended to str, so suffix array is built in one vector of
+/// str.size() + 1 cells and then shifted in place. Besides str and the result only bitmap of types and buckets are
+/// allocated.
+///
+template <typename IndexType>
+std::vector<IndexType> BuildSufArrCompact(std::string_view str) {
+    static_assert(std::is_unsigned_v<IndexType>, "IndexType must be unsigned");
+    assert(str.size() < static_cast<size_t>(std::numeric_limits<IndexType>::max()) - 1);
+
+    if (str.empty()) {
+        return {};
+    }
+
+    auto str_size = static_cast<IndexType>(str.size());
+    auto symbols = [str, str_size](IndexType i) {
+        return i == str_size ? 0
+                             : static_cast<IndexType>(static_cast<int>(str[i]) - std::numeric_limits<char>::min() + 1);
+    };
+    std::vector<IndexType> suf_arr(str.size() + 1);
+    compact_sais::BuildSufArrInPlace(symbols, suf_arr.data(), static_cast<IndexType>(str_size + 1),
+                                     static_cast<IndexType>(std::numeric_limits<unsigned char>::max() + 1));
+
+    for (size_t i = 0; i < str.size(); ++i) {
+        suf_arr[i] = suf_arr[i + 1] + 1;
+    }
+    suf_arr.pop_back();
+
+    return suf_arr;
+}
+
+/// \brief Builds suffix array with the narrowest index type fitting str and passes it to visitor
+/// \param str - given string
+/// \param visitor - callable receiving const std::vector<uint32_t>& or const std::vector<uint64_t>& that is
+/// returned by BuildSufArrCompact
+template <typename Visitor>
+decltype(auto) BuildSufArrAuto(std::string_view str, Visitor &&visitor) {
+    if (str.size() < static_cast<size_t>(std::numeric_limits<uint32_t>::max()) - 1) {
+        return visitor(BuildSufArrCompact<uint32_t>(str));
+    }
+
+    return visitor(BuildSufArrCompact<uint64_t>(str));
+}
+
+/// \brief Builds suffix array of given string by SA-IS algorithm, O(n)
+/// \param str - given string, its size must fit int
+/// \return std::vector<int> - suffix array where each suffix is represented by index where it starts in str
+/// (beginning with 1)
+///
+/// Runs BuildSufArrCompact and widens the result to int, so characters are compared as char values as well
+///
+inline std::vector<int> BuildSufArrBySais(std::string_view str) {
+    assert(str.size() <= static_cast<size_t>(std::numeric_limits<int>::max()));
+
+    std::vector<uint32_t> suf_arr = BuildSufArrCompact<uint32_t>(str);
+    std::vector<int> result(suf_arr.size());
+    for (size_t i = 0; i < suf_arr.size(); ++i) {
+        result[i] = static_cast<int>(suf_arr[i]);
+    }
+
+    return result;
+}
+
+/*! \enum SufArrAlgorithm
+    \brief Algorithm used by BuildSufArr
+
+    kPrefixDoubling - prefix doubling with comparison sort, O(n log^2 n)
+    kRadixDoubling - prefix doubling with radix sort, O(n log n)
+    kParallelDoubling - prefix doubling on std::thread::hardware_concurrency() threads, O(n log^2 n / threads)
+    kSais - SA-IS induced sorting, O(n)
+*/
+enum class SufArrAlgorithm { kPrefixDoubling, kRadixDoubling, kParallelDoubling, kSais };
+
+/// \brief Builds suffix array of given string
+/// \param str - given string
+/// \param algorithm - algorithm that is used
+/// \return std::vector<int> - suffix array where each suffix is represented by index where it starts in str
+/// (beginning with 1)
+inline std::vector<int> BuildSufArr(std::string_view str,
+                                    SufArrAlgorithm algorithm = SufArrAlgorithm::kPrefixDoubling) {
+    switch (algorithm) {
+        case SufArrAlgorithm::kRadixDoubling:
+            return BuildSufArrByRadixDoubling(str);
+        case SufArrAlgorithm::kParallelDoubling:
+            return BuildSufArrInParallel(str);
+        case SufArrAlgorithm::kSais:
+            return BuildSufArrBySais(str);
+        case SufArrAlgorithm::kPrefixDoubling:
+        default:
+            return BuildSufArrByPrefixDoubling(str);
+    }
+}
+
+/*! \class SuffixArrayIndex
+    \brief Index over string answering substring queries with the help of its suffix array
+
+    \param text_ - indexed string
+    \param suf_arr_ - suffix array of text_ (beginning with 0)
+    \param ranks_ - inverse permutation of suf_arr_: position of each suffix in suf_arr_
+    \param lcp_ - lcp_[i] is the length of the longest common prefix of suffixes suf_arr_[i] and suf_arr_[i + 1]
+    \param lcp_sparse_table_ - sparse table of minimums over lcp_, level k contains minimums of segments of length 2^k
+
+    Index is built once in O(n log n), pattern queries take O(|pattern| log n), longest common prefix of two
+    suffixes is found in O(1). Positions in queries and results begin with 1 as in BuildSufArr. Empty pattern is
+    considered to enter at every position of text. IndexType is the type of suffix array elements: int for
+    BuildSufArr, uint32_t or uint64_t for BuildSufArrCompact and BuildSufArrAuto.
+*/
+template <typename IndexType = int>
+class SuffixArrayIndex {
+public:
+    /// \brief Builds index from string and its suffix array
+    /// \param text - indexed string
+    /// \param suf_arr - suffix array returned by BuildSufArr or BuildSufArrCompact for text
+    SuffixArrayIndex(std::string text, const std::vector<IndexType> &suf_arr)
+        : text_(std::move(text)), suf_arr_(suf_arr.size()), ranks_(suf_arr.size()), lcp_(), lcp_sparse_table_() {
+        assert(suf_arr.size() == text_.size());
+
+        for (size_t i = 0; i < suf_arr.size(); ++i) {
+            suf_arr_[i] = suf_arr[i] - 1;
+            ranks_[static_cast<size_t>(suf_arr_[i])] = static_cast<IndexType>(i);
+        }
+
+        CalculateLcp();
+        BuildLcpSparseTable();
+    }
+
+    /// \brief Finds range of suffix array consisting of suffixes beginning with pattern
+    /// \param pattern - searched string
+    /// \return std::pair<size_t, size_t> - half-open range [first, second) of positions in suffix array
+    ///
+    /// Suffixes are compared as char values, the same way suffix array is built, so bytes above 0x7f are smaller
+    /// than ASCII ones. std::string_view::compare can't be used: it compares bytes as unsigned char.
+    ///
+    std::pair<size_t, size_t> FindRange(std::string_view pattern) const {
+        std::string_view text = text_;
+        auto suffix_less = [&text](IndexType suffix, std::string_view str) {
+            std::string_view prefix = text.substr(static_cast<size_t>(suffix), str.size());
+            return std::lexicographical_compare(prefix.cbegin(), prefix.cend(), str.cbegin(), str.cend());
+        };
+        auto less_suffix = [&text](std::string_view str, IndexType suffix) {
+            std::string_view prefix = text.substr(static_cast<size_t>(suffix), str.size());
+            return std::lexicographical_compare(str.cbegin(), str.cend(), prefix.cbegin(), prefix.cend());
+        };
+        auto range_begin = std::lower_bound(suf_arr_.cbegin(), suf_arr_.cend(), pattern, suffix_less);
+        auto range_end = std::upper_bound(range_begin, suf_arr_.cend(), pattern, less_suffix);
+
+        return {static_cast<size_t>(range_begin - suf_arr_.cbegin()),
+                static_cast<size_t>(range_end - suf_arr_.cbegin())};
+    }
+
+    /// \brief Counts enterings of pattern into text
+    /// \param pattern - searched string
+    /// \return size_t - quantity of enterings (possibly overlapping)
+    size_t CountEnterings(std::string_view pattern) const {
+        auto range = FindRange(pattern);
+
+        return range.second - range.first;
+    }
+
+    /// \brief Finds all enterings of pattern into text
+    /// \param pattern - searched string
+    /// \return std::vector<IndexType> - sorted indexes where pattern enters text (beginning with 1)
+    std::vector<IndexType> FindEnterings(std::string_view pattern) const {
+        using DifferenceType = typename std::vector<IndexType>::difference_type;
+
+        auto range = FindRange(pattern);
+        std::vector<IndexType> beginnings(suf_arr_.cbegin() + static_cast<DifferenceType>(range.first),
+                                          suf_arr_.cbegin() + static_cast<DifferenceType>(range.second));
+        for (IndexType &beginning : beginnings) {
+            ++beginning;
+        }
+        std::sort(beginnings.begin(), beginnings.end());
+
+        return beginnings;
+    }
+
+    /// \brief Finds length of the longest common prefix of two suffixes
+    /// \param first - index where the first suffix starts (beginning with 1)
+    /// \param second - index where the second suffix starts (beginning with 1)
+    /// \return IndexType - length of the longest common prefix
+    IndexType GetLcp(IndexType first, IndexType second) const {
+        assert((first >= 1) && (static_cast<size_t>(first) <= text_.size()));
+        assert((second >= 1) && (static_cast<size_t>(second) <= text_.size()));
+
+        if (first == second) {
+            return static_cast<IndexType>(text_.size()) - first + 1;
+        }
+
+        IndexType first_rank = ranks_[static_cast<size_t>(first - 1)];
+        IndexType second_rank = ranks_[static_cast<size_t>(second - 1)];
+        if (first_rank > second_rank) {
+            std::swap(first_rank, second_rank);
+        }
+
+        return GetLcpMinimum(static_cast<size_t>(first_rank), static_cast<size_t>(second_rank));
+    }
+
+    /// \brief Finds the longest substring entering text at least twice
+    /// \return std::string_view - the leftmost in suffix array order of the longest repeated substrings (empty if none)
+    std::string_view GetLongestRepeatedSubstring() const {
+        auto lcp_maximum = std::max_element(lcp_.cbegin(), lcp_.cend());
+        if ((lcp_maximum == lcp_.cend()) || (*lcp_maximum == 0)) {
+            return {};
+        }
+
+        size_t beginning = static_cast<size_t>(suf_arr_[static_cast<size_t>(lcp_maximum - lcp_.cbegin())]);
+
+        return std::string_view(text_).substr(beginning, static_cast<size_t>(*lcp_maximum));
+    }
+
+    /// \brief Counts different non-empty substrings of text
+    /// \return uint64_t - quantity of different substrings
+    uint64_t GetDistinctSubstringsQuantity() const {
+        uint64_t text_size = text_.size();
+        uint64_t result = text_size * (text_size + 1) / 2;
+        for (IndexType lcp : lcp_) {
+            result -= static_cast<uint64_t>(lcp);
+        }
+
+        return result;
+    }
+
+    /// \brief Gives LCP array
+    /// \return const std::vector<IndexType>& - lengths of the longest common prefixes of neighbours in suffix array
+    const std::vector<IndexType> &GetLcpArray() const {
+        return lcp_;
+    }
+
+private:
+    /// \brief Kasai algorithm: calculates lcp_ in O(n)
+    void CalculateLcp() {
+        size_t text_size = text_.size();
+        lcp_.assign(text_size == 0 ? 0 : text_size - 1, 0);
+
+        size_t common_length = 0;
+        for (size_t suffix = 0; suffix < text_size; ++suffix) {
+            size_t rank = static_cast<size_t>(ranks_[suffix]);
+            if (rank + 1 == text_size) {
+                common_length = 0;
+                continue;
+            }
+
+            size_t next_suffix = static_cast<size_t>(suf_arr_[rank + 1]);
+            while ((suffix + common_length < text_size) && (next_suffix + common_length < text_size) &&
+                   (text_[suffix + common_length] == text_[next_suffix + common_length])) {
+                ++common_length;
+            }
+            lcp_[rank] = static_cast<IndexType>(common_length);
+
+            if (common_length > 0) {
+                --common_length;
+            }
+        }
+    }
+
+    /// \brief Builds lcp_sparse_table_ in O(n log n)
+    void BuildLcpSparseTable() {
+        size_t lcp_size = lcp_.size();
+        lcp_sparse_table_.clear();
+        lcp_sparse_table_.push_back(lcp_);
+        for (size_t length = 2; length <= lcp_size; length *= 2) {
+            const std::vector<IndexType> &prev_level = lcp_sparse_table_.back();
+            std::vector<IndexType> level(lcp_size - length + 1);
+            for (size_t i = 0; i < level.size(); ++i) {
+                level[i] = std::min(prev_level[i], prev_level[i + length / 2]);
+            }
+            lcp_sparse_table_.push_back(std::move(level));
+        }
+    }
+
+    /// \brief Finds minimum of lcp_ over [first_rank, second_rank)
+    IndexType GetLcpMinimum(size_t first_rank, size_t second_rank) const {
+        size_t length = second_rank - first_rank;
+        size_t level = static_cast<size_t>(std::numeric_limits<unsigned long long>::digits - 1 -
+                                           __builtin_clzll(static_cast<unsigned long long>(length)));
+        const std::vector<IndexType> &table_level = lcp_sparse_table_[level];
+
+        return std::min(table_level[first_rank], table_level[second_rank - (static_cast<size_t>(1) << level)]);
+    }
+
+    std::string text_;
+    std::vector<IndexType> suf_arr_;
+    std::vector<IndexType> ranks_;
+    std::vector<IndexType> lcp_;
+    std::vector<std::vector<IndexType>> lcp_sparse_table_;
+};
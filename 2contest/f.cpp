@@ -1,106 +1,145 @@
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <deque>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
+#include "../common/thread_pool.h"
+#include "../common/uint128.h"
+
+/*! \enum PrimesCountingEngine
+    \brief Algorithm used by PrimesQuantity
+
+    kAuto - kLucy for small ceil or several threads, kMeisselLehmer for big ceil on one thread
+    kLucy - Lucy_Hedgehog dynamic programming over subsqrts and paired numbers, O(n^(3/4))
+    kMeisselLehmer - Meissel-Lehmer-Lagarias-Miller-Odlyzko with segmented sieve for special leaves, O(n^(2/3))
+*/
+enum class PrimesCountingEngine { kAuto, kLucy, kMeisselLehmer };
+
 /*! \class PrimesQuantity
     \brief Class that counts quantity of prime numbers from 2 to argument ceil in constructor
 
     \param ceil_ - value until for which all is being calculated
     \param subsqrts_and_paired_ - vector which contains all numbers(called subsqrts) from 2 to trunc(sqrt(ceil_))
                                   and numbers that are received by doing ceil_ / subsqrt for each of subsqrt number
+    \param engine_ - algorithm that is used for counting
+    \param threads_quantity_ - quantity of threads running Lucy DP rounds
+    \param thread_pool_ - threads kept between rounds, created on the first multithreaded count
+    \param dp_ - quantities of primes up to each of subsqrts_and_paired_ kept after Lucy DP
     Class goes through subsqrts_and_paired vector, counting prime numbers quantity
 */
 class PrimesQuantity {
 public:
-    explicit PrimesQuantity(uint64_t ceil) : ceil_(ceil) {
+    /// Since this ceil Meissel-Lehmer is faster than Lucy DP
+    static constexpr uint64_t kMeisselLehmerThreshold = 10'000'000'000ULL;
+
+    /// Bands of dp smaller than this are updated by the calling thread only
+    static constexpr uint64_t kParallelBandSize = 1 << 15;
+
+    /// Dividends of DivideByReciprocal since which double product is not exact enough: 2^53
+    static constexpr uint64_t kReciprocalDividendLimit = static_cast<uint64_t>(1) << 53;
+
+    /// \param ceil - upper border for counting prime numbers
+    /// \param engine - algorithm that is used for counting
+    /// \param threads_quantity - quantity of threads for Lucy DP; 0 means std::thread::hardware_concurrency()
+    explicit PrimesQuantity(uint64_t ceil, PrimesCountingEngine engine = PrimesCountingEngine::kAuto,
+                            size_t threads_quantity = 1)
+        : ceil_(ceil), engine_(engine), threads_quantity_(threads_quantity) {
+        if (threads_quantity_ == 0) {
+            threads_quantity_ = std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+        }
+        if (engine_ == PrimesCountingEngine::kAuto) {
+            engine_ = (ceil_ >= kMeisselLehmerThreshold) && (threads_quantity_ == 1)
+                          ? PrimesCountingEngine::kMeisselLehmer
+                          : PrimesCountingEngine::kLucy;
+        }
     }
 
     /// \brief Counts prime numbers quantity from 1 to ceil
     /// \param ceil - upper border for counting prime numbers
     /// \return quantity of prime numbers
     uint64_t GetPrimesQuantity() {
-        subsqrts_and_paired_ = GetSubsqrtsAndPaired(ceil_);
-        auto subsqrts_and_paired_begin = subsqrts_and_paired_.cbegin();
-        auto subsqrts_and_paired_end = subsqrts_and_paired_.end() - 1;  // last element is trunc(sqrt(ceil))
-        auto subsqrts_and_paired_iterator = subsqrts_and_paired_begin;
-        uint64_t trunc_sqrt = *subsqrts_and_paired_end;
-
-        std::vector<uint64_t> dp(subsqrts_and_paired_end - subsqrts_and_paired_begin);
-        auto dp_begin = dp.begin();
-        auto dp_end = dp.end();
-        auto dp_iterator = dp_begin;
-        while (dp_iterator != dp_end) {
-            *dp_iterator = *subsqrts_and_paired_iterator;
-
-            ++dp_iterator;
-            ++subsqrts_and_paired_iterator;
-        }
-
-        uint64_t values_used_in_sieving = 0;
-        for (uint64_t subsqrt = 2; subsqrt * subsqrt <= ceil_; ++subsqrt) {
-
-            if (*(dp_begin + static_cast<std::vector<uint64_t>::difference_type>(
-                                 GetCorrectIndex(subsqrts_and_paired_, trunc_sqrt, ceil_, subsqrt - 1))) !=
-                *(dp_begin + static_cast<std::vector<uint64_t>::difference_type>(
-                                 GetCorrectIndex(subsqrts_and_paired_, trunc_sqrt, ceil_, subsqrt)))) {
-                ++values_used_in_sieving;
-
-                subsqrts_and_paired_iterator = subsqrts_and_paired_end - 1;
-                dp_iterator = dp_end - 1;
-                while (subsqrts_and_paired_iterator != subsqrts_and_paired_begin) {
-                    if (*subsqrts_and_paired_iterator < subsqrt * subsqrt) {
-                        break;
-                    }
+        if (engine_ == PrimesCountingEngine::kMeisselLehmer) {
+            return GetPrimesQuantityByMeisselLehmer();
+        }
 
-                    *dp_iterator -= *(dp.begin() + static_cast<std::vector<uint64_t>::difference_type>(
-                                                       GetCorrectIndex(subsqrts_and_paired_, trunc_sqrt, ceil_,
-                                                                        *subsqrts_and_paired_iterator / subsqrt))) -
-                                    values_used_in_sieving;
+        return GetPrimesQuantityByLucy();
+    }
 
-                    --subsqrts_and_paired_iterator;
-                    --dp_iterator;
+    /// \brief Finds integer root
+    /// \param value - number whose root is found
+    /// \param degree - degree of root (2 or 3)
+    /// \return the largest root such that root^degree <= value
+    static uint64_t GetIntegerRoot(uint64_t value, int degree) {
+        auto root = static_cast<uint64_t>(std::pow(static_cast<long double>(value), 1.0L / degree));
+        auto power_fits = [value, degree](uint64_t base) {
+            uint64_t power = 1;
+            for (int i = 0; i < degree; ++i) {
+                if ((base != 0) && (power > value / base)) {
+                    return false;
                 }
+                power *= base;
             }
+
+            return power <= value;
+        };
+        while ((root > 0) && (!power_fits(root))) {
+            --root;
+        }
+        while (power_fits(root + 1)) {
+            ++root;
         }
 
-        return *(dp_begin + static_cast<std::vector<uint64_t>::difference_type>(
-                                GetCorrectIndex(subsqrts_and_paired_, trunc_sqrt, ceil_, ceil_))) -
-               1;
+        return root;
+    }
+
+    /// \brief Divides by number whose reciprocal is precomputed
+    /// \param dividend - number that is divided
+    /// \param divisor - number by which dividend is divided
+    /// \param reciprocal - 1.0 / divisor
+    /// \return trunc(dividend / divisor)
+    ///
+    /// Product by reciprocal is corrected by one step only while dividend < kReciprocalDividendLimit: then dividend
+    /// converts to double exactly and error of the product is less than 1. Bigger dividends are divided as integers.
+    ///
+    static uint64_t DivideByReciprocal(uint64_t dividend, uint64_t divisor, double reciprocal) {
+        if (dividend >= kReciprocalDividendLimit) {
+            return dividend / divisor;
+        }
+
+        auto quotient = static_cast<int64_t>(static_cast<double>(dividend) * reciprocal);
+        auto remainder = static_cast<int64_t>(dividend) - quotient * static_cast<int64_t>(divisor);
+        quotient += (remainder < 0 ? -1 : 0) + (remainder >= static_cast<int64_t>(divisor) ? 1 : 0);
+
+        return static_cast<uint64_t>(quotient);
     }
 
-private:     
     /// Trait (*): if sqrt(+) is such integer that sqrt * sqrt <= value, but (sqrt + 1) * (sqrt + 1) > value,
     ///            then both number <= sqrt and value / number are matching it, number is natural
 
     /// \brief Counts how much numbers match (*)
     /// \param value - for which quantity of numbers that match (*) is being calculated
     /// \return quantity of such numbers
-    uint64_t GetSubsqrtsAndPairedQuantity(uint64_t value) {
+    static uint64_t GetSubsqrtsAndPairedQuantity(uint64_t value) {
         assert(value != 0);
 
-        if (value == 1) {
-            return 1;
-        }
-
-        uint64_t result = 2;
-        uint64_t subsqrt = 2;
-        for (subsqrt = 2; subsqrt * subsqrt < value; ++subsqrt) {
-            result += 2;
-        }
-        if ((subsqrt - 1) * subsqrt > value) {
-            --result;
-        } else if (subsqrt * subsqrt == value) {
-            ++result;
-        }
+        uint64_t trunc_sqrt = GetIntegerRoot(value, 2);
 
-        return result;
+        return 2 * trunc_sqrt - (trunc_sqrt * (trunc_sqrt + 1) > value ? 1 : 0);
     }
 
     /// \brief Forms vector with numbers that match (*)
     /// \param value - for which numbers that match (*) are put in the vector
     /// \return std::vector<uint64_t> with numbers that match (*)
-    std::vector<uint64_t> GetSubsqrtsAndPaired(uint64_t value) {
+    static std::vector<uint64_t> GetSubsqrtsAndPaired(uint64_t value) {
         assert(value != 0);
 
         uint64_t subsqrts_and_paired_quantity = GetSubsqrtsAndPairedQuantity(value);
@@ -134,14 +173,889 @@ private:
     /// \param ceil - number for which vector with numbers that match (*) is calculated
     /// \param value - value searched for in vector
     /// \return index of value in vector
-    uint64_t GetCorrectIndex(const std::vector<uint64_t> &vector, uint64_t threshold, uint64_t ceil, uint64_t value) {
+    static uint64_t GetCorrectIndex(const std::vector<uint64_t> &vector, uint64_t threshold, uint64_t ceil,
+                                    uint64_t value) {
         return value <= threshold ? value - 1 : (vector.size() - 1) - ceil / value;
     }
 
+    PrimesCountingEngine GetEngine() const {
+        return engine_;
+    }
+
+    /// \brief Checks whether quantity of primes up to value is kept by the last Lucy DP count
+    /// \param value - number that is checked
+    /// \return true if value is one of subsqrts and paired and Lucy DP was run; false otherwise
+    bool IsComputedValue(uint64_t value) const {
+        if (dp_.empty() || (value == 0) || (value > ceil_)) {
+            return false;
+        }
+
+        return (value <= subsqrts_and_paired_.back()) || (ceil_ / (ceil_ / value) == value);
+    }
+
+    /// \brief Gives quantity of primes up to value kept by the last Lucy DP count in O(1)
+    /// \param value - one of subsqrts and paired: value <= trunc(sqrt(ceil)) or value = ceil / k
+    /// \return quantity of prime numbers from 1 to value
+    uint64_t GetComputedPrimesQuantity(uint64_t value) const {
+        assert(IsComputedValue(value));
+
+        return dp_[GetCorrectIndex(subsqrts_and_paired_, subsqrts_and_paired_.back(), ceil_, value)];
+    }
+
+private:
+    /// \brief Lucy_Hedgehog dynamic programming: dp contains quantity of numbers from 2 to each of subsqrts and
+    ///        paired which were not sieved by already processed primes
+    /// \return quantity of prime numbers from 1 to ceil_
+    ///
+    /// dp is laid out as subsqrts_and_paired_, so it splits into small part indexed by value v <= trunc(sqrt(ceil_))
+    /// and large part indexed by k for value ceil_ / k. Both are addressed directly, divisions ceil_ / (k * p) are
+    /// replaced by (ceil_ / p) / k with precomputed double reciprocals of k, v / p uses reciprocal of p.
+    ///
+    /// Every round reads only values that are not updated yet in this round: large(k) reads large(k * p), small(v)
+    /// reads small(v / p). So the round is split into bands [p^j, p^(j+1)) of k taken bottom-up and bands of v taken
+    /// top-down, and each band is updated by all threads of thread_pool_ at once.
+    ///
+    uint64_t GetPrimesQuantityByLucy() {
+        dp_.clear();
+        if (ceil_ < 2) {
+            return 0;
+        }
+
+        subsqrts_and_paired_ = GetSubsqrtsAndPaired(ceil_);
+        uint64_t trunc_sqrt = subsqrts_and_paired_.back();
+        uint64_t values_quantity = subsqrts_and_paired_.size() - 1;  // last element is trunc(sqrt(ceil))
+        uint64_t large_quantity = values_quantity - trunc_sqrt;     // values ceil_ / k > trunc_sqrt for k <= it
+
+        dp_.assign(values_quantity, 0);
+        std::vector<uint64_t> &dp = dp_;
+        for (uint64_t i = 0; i < values_quantity; ++i) {
+            dp[i] = subsqrts_and_paired_[i] - 1;
+        }
+        auto small = [&dp](uint64_t value) -> uint64_t & { return dp[value - 1]; };
+        auto large = [&dp, values_quantity](uint64_t k) -> uint64_t & { return dp[values_quantity - k]; };
+
+        std::vector<double> reciprocals(large_quantity + 1, 0);
+        for (uint64_t k = 1; k <= large_quantity; ++k) {
+            reciprocals[k] = 1.0 / static_cast<double>(k);
+        }
+
+        if ((threads_quantity_ > 1) && (thread_pool_ == nullptr)) {
+            thread_pool_ = std::make_unique<ThreadPool>(threads_quantity_);
+        }
+        auto update_band = [this](uint64_t begin, uint64_t end, const auto &update) {
+            if ((thread_pool_ == nullptr) || (end - begin < kParallelBandSize)) {
+                update(begin, end);
+            } else {
+                thread_pool_->ParallelFor(begin, end, update);
+            }
+        };
+
+        for (uint64_t prime = 2; prime <= trunc_sqrt; ++prime) {
+            if (small(prime) == small(prime - 1)) {
+                continue;
+            }
+
+            uint64_t primes_before = small(prime - 1);
+            uint64_t prime_square = prime * prime;
+            uint64_t ceil_by_prime = ceil_ / prime;
+            uint64_t large_updated = std::min(large_quantity, ceil_ / prime_square);
+            uint64_t large_paired = std::min(large_updated, large_quantity / prime);  // k * prime is still large
+            auto update_large = [&](uint64_t begin, uint64_t end) {
+                for (uint64_t k = begin; k < std::min(end, large_paired + 1); ++k) {
+                    large(k) -= large(k * prime) - primes_before;
+                }
+                for (uint64_t k = std::max(begin, large_paired + 1); k < end; ++k) {
+                    large(k) -= small(DivideByReciprocal(ceil_by_prime, k, reciprocals[k])) - primes_before;
+                }
+            };
+            for (uint64_t band_begin = 1; band_begin <= large_updated; band_begin *= prime) {
+                update_band(band_begin, std::min(band_begin * prime, large_updated + 1), update_large);
+            }
+
+            double prime_reciprocal = 1.0 / static_cast<double>(prime);
+            auto update_small = [&](uint64_t begin, uint64_t end) {
+                for (uint64_t value = end - 1; value >= begin; --value) {
+                    small(value) -= small(DivideByReciprocal(value, prime, prime_reciprocal)) - primes_before;
+                }
+            };
+            if (prime_square <= trunc_sqrt) {
+                uint64_t band_begin = prime_square;
+                while (band_begin <= trunc_sqrt / prime) {
+                    band_begin *= prime;
+                }
+                for (uint64_t band_end = trunc_sqrt + 1; band_end > prime_square; band_begin /= prime) {
+                    update_band(band_begin, band_end, update_small);
+                    band_end = band_begin;
+                }
+            }
+        }
+
+        return dp.back();
+    }
+
+    /// \brief Meissel-Lehmer algorithm in Lagarias-Miller-Odlyzko form
+    /// \return quantity of prime numbers from 1 to ceil_
+    ///
+    /// pi(x) = phi(x, a) + a - 1 - P2(x, a), where a = pi(y), y = alpha * x^(1/3). phi(x, a) is split into ordinary
+    /// leaves mu(n) * phi(x / n, c) for n <= y and special leaves -mu(m) * phi(x / (p_b * m), b - 1) for
+    /// m <= y < p_b * m, b > c. phi(v, c) for the first c primes is taken from table of one primorial period, special
+    /// leaves are counted during segmented sieve of [1, x / y] with Fenwick tree over the segment. P2(x, a) counts
+    /// numbers consisting of two primes greater than y, primes up to x / y are counted by one more segmented sieve.
+    ///
+    uint64_t GetPrimesQuantityByMeisselLehmer() {
+        uint64_t ceil = ceil_;
+        if (ceil < kMeisselLehmerSmallCeil) {
+            uint64_t result = 0;
+            std::vector<bool> is_composite(ceil + 1, false);
+            for (uint64_t value = 2; value <= ceil; ++value) {
+                if (!is_composite[value]) {
+                    ++result;
+                    for (uint64_t multiple = value * value; multiple <= ceil; multiple += value) {
+                        is_composite[multiple] = true;
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        uint64_t sqrt_ceil = GetIntegerRoot(ceil, 2);
+        uint64_t cbrt_ceil = GetIntegerRoot(ceil, 3);
+        auto alpha = static_cast<uint64_t>(std::max(1.0L, std::log(static_cast<long double>(ceil)) / 6));
+        uint64_t y = std::min(sqrt_ceil, cbrt_ceil * alpha);
+
+        std::vector<int8_t> moebius(y + 1, 1);
+        std::vector<uint32_t> least_prime_factors(y + 1, 0);
+        std::vector<uint64_t> primes{0};  // primes are numbered from 1
+        for (uint64_t value = 2; value <= y; ++value) {
+            if (least_prime_factors[value] == 0) {
+                primes.push_back(value);
+                for (uint64_t multiple = value; multiple <= y; multiple += value) {
+                    if (least_prime_factors[multiple] == 0) {
+                        least_prime_factors[multiple] = static_cast<uint32_t>(value);
+                    }
+                    moebius[multiple] = static_cast<int8_t>(-moebius[multiple]);
+                }
+                if (value <= y / value) {
+                    for (uint64_t multiple = value * value; multiple <= y; multiple += value * value) {
+                        moebius[multiple] = 0;
+                    }
+                }
+            }
+        }
+        least_prime_factors[1] = UINT32_MAX;
+        uint64_t a = primes.size() - 1;
+
+        uint64_t presieved_quantity = std::min(a, kMeisselLehmerPresievedQuantity);
+        assert(presieved_quantity > 0);  // y >= 10 since ceil >= kMeisselLehmerSmallCeil
+        uint64_t primorial = 1;
+        for (uint64_t b = 1; b <= presieved_quantity; ++b) {
+            primorial *= primes[b];
+        }
+        std::vector<uint32_t> coprimes_quantities(primorial + 1, 0);  // quantities of numbers from [1, r] coprime to
+        for (uint64_t r = 1; r <= primorial; ++r) {                   // primorial
+            bool is_coprime = true;
+            for (uint64_t b = 1; b <= presieved_quantity; ++b) {
+                is_coprime = is_coprime && (r % primes[b] != 0);
+            }
+            coprimes_quantities[r] = coprimes_quantities[r - 1] + (is_coprime ? 1 : 0);
+        }
+
+        int64_t phi = 0;
+        for (uint64_t n = 1; n <= y; ++n) {
+            if ((moebius[n] != 0) && (least_prime_factors[n] > primes[presieved_quantity])) {
+                uint64_t value = ceil / n;
+                uint64_t presieved_phi =
+                    value / primorial * coprimes_quantities[primorial] + coprimes_quantities[value % primorial];
+                phi += moebius[n] * static_cast<int64_t>(presieved_phi);
+            }
+        }
+        phi += CountSpecialLeaves(y, presieved_quantity, primes, moebius, least_prime_factors, coprimes_quantities);
+
+        return static_cast<uint64_t>(phi) + a - 1 - CountTwoPrimesProducts(y, sqrt_ceil, primes);
+    }
+
+    /// \brief Counts sum of special leaves of phi(ceil_, a)
+    /// \param y - border between ordinary and special leaves
+    /// \param presieved_quantity - quantity c of the first primes that are presieved
+    /// \param primes - reference to primes up to y numbered from 1
+    /// \param moebius - reference to Moebius function up to y
+    /// \param least_prime_factors - reference to the least prime factors up to y (infinity for 1)
+    /// \param coprimes_quantities - reference to quantities of numbers from [1, r] coprime to the first c primes
+    /// \return sum of -mu(m) * phi(ceil_ / (p_b * m), b - 1) for all m <= y < p_b * m with lpf(m) > p_b, b > c
+    int64_t CountSpecialLeaves(uint64_t y, uint64_t presieved_quantity, const std::vector<uint64_t> &primes,
+                               const std::vector<int8_t> &moebius, const std::vector<uint32_t> &least_prime_factors,
+                               const std::vector<uint32_t> &coprimes_quantities) {
+        uint64_t ceil = ceil_;
+        uint64_t sieve_limit = ceil / y;
+        uint64_t segment_size = 1;
+        while (segment_size * segment_size < sieve_limit) {
+            segment_size *= 2;
+        }
+        segment_size = std::max<uint64_t>(segment_size, 1 << 16);
+        uint64_t a = primes.size() - 1;
+        uint64_t primorial = coprimes_quantities.size() - 1;
+
+        int64_t result = 0;
+        std::vector<uint64_t> phi(a + 1, 0);  // phi[b] - numbers before segment not divisible by p_1, ..., p_(b-1)
+        std::vector<char> is_sieved(segment_size);
+        std::vector<uint32_t> fenwick_tree(segment_size);
+        for (uint64_t low = 1; low <= sieve_limit; low += segment_size) {
+            uint64_t high = std::min(low + segment_size, sieve_limit + 1);
+            auto current_size = static_cast<int64_t>(high - low);
+            std::fill(fenwick_tree.begin(), fenwick_tree.end(), 0);
+            uint64_t unsieved_quantity = 0;
+            uint64_t remainder = low % primorial;
+            for (int64_t i = 0; i < current_size; ++i) {
+                is_sieved[i] = remainder == 0 || coprimes_quantities[remainder] == coprimes_quantities[remainder - 1];
+                if (!is_sieved[i]) {
+                    ++fenwick_tree[i];
+                    ++unsieved_quantity;
+                }
+                int64_t parent = i | (i + 1);
+                if (parent < current_size) {
+                    fenwick_tree[parent] += fenwick_tree[i];
+                }
+                remainder = remainder + 1 == primorial ? 0 : remainder + 1;
+            }
+
+            auto count_unsieved = [&](uint64_t n) {
+                uint64_t unsieved = 0;
+                for (auto i = static_cast<int64_t>(n - low); i >= 0; i = (i & (i + 1)) - 1) {
+                    unsieved += fenwick_tree[i];
+                }
+
+                return unsieved;
+            };
+            for (uint64_t b = presieved_quantity + 1; b < a; ++b) {
+                uint64_t prime = primes[b];
+                uint64_t min_m = std::max(ceil / (prime * high), y / prime);
+                uint64_t max_m = std::min(ceil / (prime * low), y);
+                if (prime * prime <= y) {
+                    for (uint64_t m = max_m; m > min_m; --m) {
+                        if ((moebius[m] != 0) && (least_prime_factors[m] > prime)) {
+                            uint64_t unsieved = phi[b] + count_unsieved(ceil / (prime * m));
+                            result -= moebius[m] * static_cast<int64_t>(unsieved);
+                        }
+                    }
+                } else {
+                    // all prime factors of m are greater than sqrt(y), so m is prime
+                    min_m = std::max(min_m, prime);
+                    auto m_iterator = std::upper_bound(primes.cbegin(), primes.cend(), max_m);
+                    while ((max_m > min_m) && (*(--m_iterator) > min_m)) {
+                        result += static_cast<int64_t>(phi[b] + count_unsieved(ceil / (prime * *m_iterator)));
+                    }
+                }
+
+                phi[b] += unsieved_quantity;
+                for (uint64_t multiple = std::max(prime, (low + prime - 1) / prime * prime); multiple < high;
+                     multiple += prime) {
+                    auto i = static_cast<int64_t>(multiple - low);
+                    if (!is_sieved[i]) {
+                        is_sieved[i] = true;
+                        --unsieved_quantity;
+                        for (; i < current_size; i |= i + 1) {
+                            --fenwick_tree[i];
+                        }
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    /// \brief Counts numbers up to ceil_ that are products of two primes greater than y
+    /// \param y - lower border for primes
+    /// \param sqrt_ceil - trunc(sqrt(ceil_))
+    /// \param primes - reference to primes up to y numbered from 1
+    /// \return sum of pi(ceil_ / p) - pi(p) + 1 for all primes y < p <= sqrt(ceil_)
+    uint64_t CountTwoPrimesProducts(uint64_t y, uint64_t sqrt_ceil, const std::vector<uint64_t> &primes) {
+        uint64_t ceil = ceil_;
+        std::vector<bool> is_composite(sqrt_ceil + 1, false);
+        std::vector<uint64_t> big_primes;
+        uint64_t primes_quantity_up_to_y = primes.size() - 1;
+        for (uint64_t value = 2; value <= sqrt_ceil; ++value) {
+            if (!is_composite[value]) {
+                if (value > y) {
+                    big_primes.push_back(value);
+                }
+                if (value <= sqrt_ceil / value) {
+                    for (uint64_t multiple = value * value; multiple <= sqrt_ceil; multiple += value) {
+                        is_composite[multiple] = true;
+                    }
+                }
+            }
+        }
+        if (big_primes.empty()) {
+            return 0;
+        }
+
+        uint64_t result = 0;
+        uint64_t prime_index = primes_quantity_up_to_y + big_primes.size();  // index of the largest big prime
+        uint64_t sieve_limit = ceil / y;
+        uint64_t segment_size = 1 << 18;
+        std::vector<char> is_sieved(segment_size);
+        uint64_t primes_before_segment = 0;
+        auto big_primes_iterator = big_primes.crbegin();
+        for (uint64_t low = 0; (low <= sieve_limit) && (big_primes_iterator != big_primes.crend());
+             low += segment_size) {
+            uint64_t high = std::min(low + segment_size, sieve_limit + 1);
+            std::fill(is_sieved.begin(), is_sieved.end(), false);
+            for (uint64_t value = low; value < std::min<uint64_t>(high, 2); ++value) {
+                is_sieved[value - low] = true;
+            }
+            for (uint64_t b = 1; (b < primes.size()) && (primes[b] * primes[b] < high); ++b) {
+                uint64_t prime = primes[b];
+                for (uint64_t multiple = std::max(prime * prime, (low + prime - 1) / prime * prime); multiple < high;
+                     multiple += prime) {
+                    is_sieved[multiple - low] = true;
+                }
+            }
+
+            uint64_t value = low;
+            uint64_t primes_quantity = primes_before_segment;
+            while ((big_primes_iterator != big_primes.crend()) && (ceil / *big_primes_iterator < high)) {
+                uint64_t target = ceil / *big_primes_iterator;
+                for (; value <= target; ++value) {
+                    primes_quantity += is_sieved[value - low] ? 0 : 1;
+                }
+                result += primes_quantity - prime_index + 1;
+
+                --prime_index;
+                ++big_primes_iterator;
+            }
+            for (; value < high; ++value) {
+                primes_quantity += is_sieved[value - low] ? 0 : 1;
+            }
+            primes_before_segment = primes_quantity;
+        }
+
+        return result;
+    }
+
 private:
     //-----------------------------------Variables-------------------------------------
+    /// Below this ceil Meissel-Lehmer engine counts primes by plain sieve
+    static constexpr uint64_t kMeisselLehmerSmallCeil = 1000;
+    /// Quantity of the first primes (2, ..., 13) that are presieved by Meissel-Lehmer engine
+    static constexpr uint64_t kMeisselLehmerPresievedQuantity = 6;
+
+    uint64_t ceil_;
+    PrimesCountingEngine engine_;
+    size_t threads_quantity_;
+    std::unique_ptr<ThreadPool> thread_pool_;
+    std::vector<uint64_t> subsqrts_and_paired_;
+    std::vector<uint64_t> dp_;
+};
+
+/*! \class PrimesQuantityOracle
+    \brief Answers many queries of quantity of primes up to x <= ceil after one Lucy DP for ceil
+
+    \param ceil_ - the largest value that may be queried
+    \param lucy_ - PrimesQuantity that keeps pi(ceil_ / k) for all k
+    \param sieving_primes_ - primes up to sqrt(ceil_ + kBlockSize)
+    \param blocks_bases_ - checkpoint table: quantities of primes less than beginnings of blocks that are known
+    \param cached_blocks_ - sieved blocks, the oldest one is dropped when there are kMaxCachedBlocks of them
+    \param cached_order_ - indexes of cached blocks in the order they were sieved
+
+    pi(ceil / k) is taken from Lucy DP in O(1). For another x, numbers are split into blocks of kBlockSize,
+    pi(x) = (primes before block of x) + (primes in block up to x). Quantity of primes before block is taken from
+    checkpoint table or reached from the nearest anchor (known checkpoint or value ceil / k) by segmented sieve,
+    all blocks passed on the way are added to checkpoint table. If all anchors are too far, it is counted directly.
+*/
+class PrimesQuantityOracle {
+public:
+    static constexpr uint64_t kBlockSize = 1 << 18;
+    static constexpr size_t kMaxCachedBlocks = 256;
+
+    /// \param ceil - the largest value that may be queried
+    /// \param threads_quantity - quantity of threads for Lucy DP; 0 means std::thread::hardware_concurrency()
+    explicit PrimesQuantityOracle(uint64_t ceil, size_t threads_quantity = 1)
+        : ceil_(ceil), lucy_(ceil, PrimesCountingEngine::kLucy, threads_quantity) {
+        lucy_.GetPrimesQuantity();
+
+        uint64_t sieving_limit = PrimesQuantity::GetIntegerRoot(ceil_ + kBlockSize, 2);
+        std::vector<bool> is_composite(sieving_limit + 1, false);
+        for (uint64_t value = 2; value <= sieving_limit; ++value) {
+            if (!is_composite[value]) {
+                sieving_primes_.push_back(value);
+                for (uint64_t multiple = value * value; multiple <= sieving_limit; multiple += value) {
+                    is_composite[multiple] = true;
+                }
+            }
+        }
+    }
+
+    /// \brief Gives pi(ceil / k) in O(1)
+    /// \param k - divisor of ceil
+    /// \return quantity of prime numbers from 1 to trunc(ceil / k)
+    uint64_t GetPairedPrimesQuantity(uint64_t k) const {
+        assert(k != 0);
+
+        uint64_t value = ceil_ / k;
+
+        return value < 2 ? 0 : lucy_.GetComputedPrimesQuantity(value);
+    }
+
+    /// \brief Counts primes up to value
+    /// \param value - upper border for counting prime numbers, value <= ceil
+    /// \return quantity of prime numbers from 1 to value
+    uint64_t GetPrimesQuantity(uint64_t value) {
+        assert(value <= ceil_);
+
+        if (value < 2) {
+            return 0;
+        }
+        if (lucy_.IsComputedValue(value)) {
+            return lucy_.GetComputedPrimesQuantity(value);
+        }
+
+        uint64_t block = value / kBlockSize;
+
+        return GetBlockBase(block) + CountBlockPrimes(block, value % kBlockSize + 1);
+    }
+
+    /// \brief Counts primes up to each of values, queries are answered in ascending order to share sieved blocks
+    /// \param values - reference to upper borders, each one <= ceil
+    /// \return std::vector<uint64_t> with quantities of primes in the same order as values
+    std::vector<uint64_t> GetPrimesQuantities(const std::vector<uint64_t> &values) {
+        std::vector<size_t> order(values.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&values](size_t first, size_t second) {
+            return values[first] < values[second];
+        });
+
+        std::vector<uint64_t> result(values.size());
+        for (size_t index : order) {
+            result[index] = GetPrimesQuantity(values[index]);
+        }
+
+        return result;
+    }
+
+private:
+    /// Primes bitset of one block and quantities of primes before each of its words
+    struct SievedBlock {
+        std::vector<uint64_t> primes_bits;
+        std::vector<uint32_t> primes_before_word;
+    };
+
+    /// \brief Sieves block or takes it from cache
+    /// \param block - index of block
+    /// \return reference to sieved block, valid until the next sieving
+    const SievedBlock &GetSievedBlock(uint64_t block) {
+        auto cached_block = cached_blocks_.find(block);
+        if (cached_block != cached_blocks_.end()) {
+            return cached_block->second;
+        }
+
+        if (cached_blocks_.size() == kMaxCachedBlocks) {
+            cached_blocks_.erase(cached_order_.front());
+            cached_order_.pop_front();
+        }
+
+        uint64_t low = block * kBlockSize;
+        uint64_t high = low + kBlockSize;
+        std::vector<char> is_composite(kBlockSize, 0);
+        for (uint64_t value = low; value < std::min<uint64_t>(high, 2); ++value) {
+            is_composite[value - low] = 1;
+        }
+        for (uint64_t prime : sieving_primes_) {
+            if (prime * prime >= high) {
+                break;
+            }
+            for (uint64_t multiple = std::max(prime * prime, (low + prime - 1) / prime * prime); multiple < high;
+                 multiple += prime) {
+                is_composite[multiple - low] = 1;
+            }
+        }
+
+        SievedBlock sieved_block{std::vector<uint64_t>(kBlockSize / 64, 0), std::vector<uint32_t>(kBlockSize / 64)};
+        uint32_t primes_quantity = 0;
+        for (uint64_t word = 0; word < kBlockSize / 64; ++word) {
+            sieved_block.primes_before_word[word] = primes_quantity;
+            for (uint64_t bit = 0; bit < 64; ++bit) {
+                if (is_composite[word * 64 + bit] == 0) {
+                    sieved_block.primes_bits[word] |= static_cast<uint64_t>(1) << bit;
+                }
+            }
+            primes_quantity += static_cast<uint32_t>(__builtin_popcountll(sieved_block.primes_bits[word]));
+        }
+
+        cached_order_.push_back(block);
+
+        return cached_blocks_.emplace(block, std::move(sieved_block)).first->second;
+    }
+
+    /// \brief Counts primes among the first numbers of block
+    /// \param block - index of block
+    /// \param numbers_quantity - quantity of the first numbers of block, from 0 to kBlockSize
+    /// \return quantity of primes among them
+    uint64_t CountBlockPrimes(uint64_t block, uint64_t numbers_quantity) {
+        if (numbers_quantity == 0) {
+            return 0;
+        }
+
+        const SievedBlock &sieved_block = GetSievedBlock(block);
+        if (numbers_quantity == kBlockSize) {
+            uint64_t last_word = kBlockSize / 64 - 1;
+
+            return sieved_block.primes_before_word[last_word] +
+                   static_cast<uint64_t>(__builtin_popcountll(sieved_block.primes_bits[last_word]));
+        }
+
+        uint64_t word = numbers_quantity / 64;
+        uint64_t mask = (static_cast<uint64_t>(1) << (numbers_quantity % 64)) - 1;
+
+        return sieved_block.primes_before_word[word] +
+               static_cast<uint64_t>(__builtin_popcountll(sieved_block.primes_bits[word] & mask));
+    }
+
+    /// \brief Finds quantity of primes less than beginning of block
+    /// \param block - index of block
+    /// \return quantity of primes from 1 to block * kBlockSize - 1
+    uint64_t GetBlockBase(uint64_t block) {
+        if (block == 0) {
+            return 0;
+        }
+        auto known_base = blocks_bases_.find(block);
+        if (known_base != blocks_bases_.end()) {
+            return known_base->second;
+        }
+
+        uint64_t value = block * kBlockSize - 1;
+        if (lucy_.IsComputedValue(value)) {
+            return blocks_bases_[block] = lucy_.GetComputedPrimesQuantity(value);
+        }
+
+        // anchors are values with known quantity of primes: lower one is reached by sieving forward, upper one is
+        // reached by sieving backward; the cost is quantity of blocks to sieve
+        uint64_t lower_anchor = 0;
+        uint64_t upper_anchor = UINT64_MAX;
+        uint64_t paired_divisor = ceil_ / value;
+        if (paired_divisor != 0) {
+            upper_anchor = ceil_ / paired_divisor;
+            lower_anchor = std::max(ceil_ / (paired_divisor + 1), PrimesQuantity::GetIntegerRoot(ceil_, 2));
+        }
+        auto next_known_base = blocks_bases_.upper_bound(block);
+        if ((next_known_base != blocks_bases_.end()) && (next_known_base->first * kBlockSize - 1 < upper_anchor)) {
+            upper_anchor = next_known_base->first * kBlockSize - 1;
+        }
+        if ((next_known_base != blocks_bases_.begin()) &&
+            (std::prev(next_known_base)->first * kBlockSize - 1 > lower_anchor)) {
+            lower_anchor = std::prev(next_known_base)->first * kBlockSize - 1;
+        }
+
+        uint64_t forward_cost = block - lower_anchor / kBlockSize;
+        uint64_t backward_cost = upper_anchor == UINT64_MAX ? UINT64_MAX : upper_anchor / kBlockSize - block + 1;
+        auto direct_cost = static_cast<uint64_t>(std::cbrt(static_cast<double>(value) * static_cast<double>(value)) /
+                                                 static_cast<double>(kBlockSize)) + 1;
+        if ((direct_cost < forward_cost) && (direct_cost < backward_cost)) {
+            return blocks_bases_[block] = PrimesQuantity(value).GetPrimesQuantity();
+        }
+
+        if (forward_cost <= backward_cost) {
+            uint64_t primes_quantity = GetAnchorPrimesQuantity(lower_anchor);
+            uint64_t current_block = lower_anchor / kBlockSize;
+            primes_quantity -= CountBlockPrimes(current_block, lower_anchor % kBlockSize + 1);
+            for (; current_block < block; ++current_block) {
+                primes_quantity += CountBlockPrimes(current_block, kBlockSize);
+                blocks_bases_[current_block + 1] = primes_quantity;
+            }
+
+            return primes_quantity;
+        }
+
+        uint64_t primes_quantity = GetAnchorPrimesQuantity(upper_anchor);
+        uint64_t current_block = upper_anchor / kBlockSize;
+        primes_quantity -= CountBlockPrimes(current_block, upper_anchor % kBlockSize + 1);
+        blocks_bases_[current_block] = primes_quantity;
+        for (; current_block > block; --current_block) {
+            primes_quantity -= CountBlockPrimes(current_block - 1, kBlockSize);
+            blocks_bases_[current_block - 1] = primes_quantity;
+        }
+
+        return primes_quantity;
+    }
+
+    /// \brief Gives quantity of primes up to anchor: value from Lucy DP or the last number before known block
+    uint64_t GetAnchorPrimesQuantity(uint64_t anchor) const {
+        if (anchor < 2) {
+            return 0;
+        }
+        if (lucy_.IsComputedValue(anchor)) {
+            return lucy_.GetComputedPrimesQuantity(anchor);
+        }
+
+        return blocks_bases_.at((anchor + 1) / kBlockSize);
+    }
+
+    uint64_t ceil_;
+    PrimesQuantity lucy_;
+    std::vector<uint64_t> sieving_primes_;
+    std::map<uint64_t, uint64_t> blocks_bases_;
+    std::unordered_map<uint64_t, SievedBlock> cached_blocks_;
+    std::deque<uint64_t> cached_order_;
+};
+
+/*! \class ModularValue
+    \brief Residue modulo kModulus that may be used as ValueType of PrimePowerSums
+
+    \param value_ - representative from [0, kModulus)
+*/
+template <uint64_t kModulus>
+class ModularValue {
+public:
+    ModularValue(uint64_t value = 0) : value_(value % kModulus) {
+    }
+
+    ModularValue &operator+=(const ModularValue &other) {
+        value_ = value_ >= kModulus - other.value_ ? value_ - (kModulus - other.value_) : value_ + other.value_;
+        return *this;
+    }
+
+    ModularValue &operator-=(const ModularValue &other) {
+        value_ = value_ >= other.value_ ? value_ - other.value_ : value_ + (kModulus - other.value_);
+        return *this;
+    }
+
+    ModularValue &operator*=(const ModularValue &other) {
+        value_ = static_cast<uint64_t>(static_cast<UnsignedInt128>(value_) * other.value_ % kModulus);
+        return *this;
+    }
+
+    friend ModularValue operator+(ModularValue first, const ModularValue &second) {
+        return first += second;
+    }
+
+    friend ModularValue operator-(ModularValue first, const ModularValue &second) {
+        return first -= second;
+    }
+
+    friend ModularValue operator*(ModularValue first, const ModularValue &second) {
+        return first *= second;
+    }
+
+    friend bool operator==(const ModularValue &first, const ModularValue &second) {
+        return first.value_ == second.value_;
+    }
+
+    friend bool operator!=(const ModularValue &first, const ModularValue &second) {
+        return first.value_ != second.value_;
+    }
+
+    uint64_t GetValue() const {
+        return value_;
+    }
+
+private:
+    uint64_t value_;
+};
+
+/*! \class PrimePowerSums
+    \brief Sums of powers of primes up to each of subsqrts and paired of ceil, all of them computed in one Lucy pass
+
+    \param ceil_ - value until for which all is being calculated
+    \param degrees_ - degree of primes for each of sums, from 0 to 3
+    \param subsqrts_and_paired_ - the same layout as PrimesQuantity uses
+    \param sums_ - sums_[i][s] is the sum of p^degrees_[s] for primes p <= subsqrts_and_paired_[i]
+    \param primes_ - primes up to trunc(sqrt(ceil_))
+
+    ValueType is uint64_t, UnsignedInt128 or ModularValue: sums are calculated modulo 2^64, 2^128 or kModulus.
+    Lucy round for prime p updates all sums of one cell at once:
+    S(v) -= p^d * (S(v / p) - S(p - 1)) for each v >= p^2.
+    Prefix sums of multiplicative function f whose values at primes are polynomial in p are found by min_25 method.
+*/
+template <typename ValueType, size_t kSumsQuantity>
+class PrimePowerSums {
+public:
+    using Sums = std::array<ValueType, kSumsQuantity>;
+
+    PrimePowerSums(uint64_t ceil, const std::array<unsigned, kSumsQuantity> &degrees) : ceil_(ceil), degrees_(degrees) {
+        for (unsigned degree : degrees_) {
+            assert(degree <= 3);
+        }
+
+        if (ceil_ < 2) {
+            return;
+        }
+
+        subsqrts_and_paired_ = PrimesQuantity::GetSubsqrtsAndPaired(ceil_);
+        uint64_t trunc_sqrt = subsqrts_and_paired_.back();
+        uint64_t values_quantity = subsqrts_and_paired_.size() - 1;  // last element is trunc(sqrt(ceil))
+        uint64_t large_quantity = values_quantity - trunc_sqrt;
+
+        sums_.resize(values_quantity);
+        for (uint64_t i = 0; i < values_quantity; ++i) {
+            for (size_t sum = 0; sum < kSumsQuantity; ++sum) {
+                sums_[i][sum] = GetPowersSum(subsqrts_and_paired_[i], degrees_[sum]) - static_cast<ValueType>(1);
+            }
+        }
+        auto small = [this](uint64_t value) -> Sums & { return sums_[value - 1]; };
+        auto large = [this, values_quantity](uint64_t k) -> Sums & { return sums_[values_quantity - k]; };
+
+        std::vector<bool> is_composite(trunc_sqrt + 1, false);
+        std::vector<double> reciprocals(large_quantity + 1, 0);
+        for (uint64_t k = 1; k <= large_quantity; ++k) {
+            reciprocals[k] = 1.0 / static_cast<double>(k);
+        }
+
+        for (uint64_t prime = 2; prime <= trunc_sqrt; ++prime) {
+            if (is_composite[prime]) {
+                continue;
+            }
+            primes_.push_back(prime);
+            for (uint64_t multiple = prime * prime; multiple <= trunc_sqrt; multiple += prime) {
+                is_composite[multiple] = true;
+            }
+
+            Sums prime_powers = GetPrimePowers(prime);
+            Sums sums_before = small(prime - 1);
+            auto update = [&](Sums &updated, const Sums &divided) {
+                for (size_t sum = 0; sum < kSumsQuantity; ++sum) {
+                    updated[sum] -= prime_powers[sum] * (divided[sum] - sums_before[sum]);
+                }
+            };
+
+            uint64_t prime_square = prime * prime;
+            uint64_t ceil_by_prime = ceil_ / prime;
+            uint64_t large_updated = std::min(large_quantity, ceil_ / prime_square);
+            uint64_t large_paired = std::min(large_updated, large_quantity / prime);  // k * prime is still large
+            for (uint64_t k = 1; k <= large_paired; ++k) {
+                update(large(k), large(k * prime));
+            }
+            for (uint64_t k = large_paired + 1; k <= large_updated; ++k) {
+                update(large(k), small(PrimesQuantity::DivideByReciprocal(ceil_by_prime, k, reciprocals[k])));
+            }
+
+            double prime_reciprocal = 1.0 / static_cast<double>(prime);
+            for (uint64_t value = trunc_sqrt; value >= prime_square; --value) {
+                update(small(value), small(PrimesQuantity::DivideByReciprocal(value, prime, prime_reciprocal)));
+            }
+        }
+    }
+
+    /// \brief Gives sums of powers of primes up to value in O(1)
+    /// \param value - one of subsqrts and paired: value <= trunc(sqrt(ceil)) or value = ceil / k
+    /// \return std::array with sum of p^degrees[s] for primes p <= value for each of sums
+    Sums GetPrimePowerSums(uint64_t value) const {
+        assert(value <= ceil_);
+
+        if (value < 2) {
+            Sums zeros;
+            zeros.fill(static_cast<ValueType>(0));
+
+            return zeros;
+        }
+
+        return sums_[PrimesQuantity::GetCorrectIndex(subsqrts_and_paired_, subsqrts_and_paired_.back(), ceil_, value)];
+    }
+
+    /// \brief min_25 method: sums multiplicative function f over [1, ceil]
+    /// \param prime_coefficients - reference to coefficients c such that f(p) = sum of c[s] * p^degrees[s]
+    /// \param prime_power_function - callable returning f(p^e) for prime p and e >= 1
+    /// \return sum of f(i) for 1 <= i <= ceil
+    template <typename PrimePowerFunction>
+    ValueType GetMultiplicativePrefixSum(const Sums &prime_coefficients,
+                                         const PrimePowerFunction &prime_power_function) const {
+        if (ceil_ == 0) {
+            return static_cast<ValueType>(0);
+        }
+
+        return static_cast<ValueType>(1) + SumWithLeastPrimeFactor(ceil_, 0, prime_coefficients, prime_power_function);
+    }
+
+private:
+    /// \brief Sums i^degree for 1 <= i <= value dividing by 2 and 3 before multiplication, so it is exact in ValueType
+    static ValueType GetPowersSum(uint64_t value, unsigned degree) {
+        if (degree == 0) {
+            return static_cast<ValueType>(value);
+        }
+
+        // value + 1 and 2 * value + 1 may not fit uint64_t, so factors are kept in 128 bits until they are reduced
+        UnsignedInt128 first = value;
+        UnsignedInt128 second = first + 1;
+        (first % 2 == 0 ? first : second) /= 2;
+        if ((degree == 1) || (degree == 3)) {
+            ValueType sum = ToValueType(first) * ToValueType(second);
+
+            return degree == 1 ? sum : sum * sum;
+        }
+
+        UnsignedInt128 third = 2 * static_cast<UnsignedInt128>(value) + 1;
+        (first % 3 == 0 ? first : second % 3 == 0 ? second : third) /= 3;
+
+        return ToValueType(first) * ToValueType(second) * ToValueType(third);
+    }
+
+    /// \brief Converts number under 2^128 to ValueType as high * 2^64 + low, so it is reduced the way ValueType is
+    static ValueType ToValueType(UnsignedInt128 number) {
+        auto high = static_cast<uint64_t>(number >> 64);
+        auto low = static_cast<uint64_t>(number);
+        ValueType half_word = static_cast<ValueType>(static_cast<uint64_t>(1) << 32);
+
+        return static_cast<ValueType>(high) * half_word * half_word + static_cast<ValueType>(low);
+    }
+
+    Sums GetPrimePowers(uint64_t prime) const {
+        Sums prime_powers;
+        for (size_t sum = 0; sum < kSumsQuantity; ++sum) {
+            prime_powers[sum] = static_cast<ValueType>(1);
+            for (unsigned i = 0; i < degrees_[sum]; ++i) {
+                prime_powers[sum] *= static_cast<ValueType>(prime);
+            }
+        }
+
+        return prime_powers;
+    }
+
+    /// \brief Sums f(p) over primes p <= value
+    ValueType GetPrimeFunctionSum(uint64_t value, const Sums &prime_coefficients) const {
+        Sums sums = GetPrimePowerSums(value);
+        ValueType result = static_cast<ValueType>(0);
+        for (size_t sum = 0; sum < kSumsQuantity; ++sum) {
+            result += prime_coefficients[sum] * sums[sum];
+        }
+
+        return result;
+    }
+
+    /// \brief Sums f(i) for 2 <= i <= value whose least prime factor is not less than primes_[prime_index]
+    /// \param value - one of subsqrts and paired
+    template <typename PrimePowerFunction>
+    ValueType SumWithLeastPrimeFactor(uint64_t value, size_t prime_index, const Sums &prime_coefficients,
+                                      const PrimePowerFunction &prime_power_function) const {
+        if ((value < 2) || ((prime_index > 0) && (primes_[prime_index - 1] >= value))) {
+            return static_cast<ValueType>(0);
+        }
+
+        ValueType result = GetPrimeFunctionSum(value, prime_coefficients);
+        if (prime_index > 0) {
+            result -= GetPrimeFunctionSum(primes_[prime_index - 1], prime_coefficients);
+        }
+
+        for (size_t i = prime_index; (i < primes_.size()) && (primes_[i] <= value / primes_[i]); ++i) {
+            uint64_t prime = primes_[i];
+            uint64_t prime_power = prime;
+            for (unsigned exponent = 1; prime_power <= value / prime; ++exponent, prime_power *= prime) {
+                result += prime_power_function(prime, exponent) *
+                              SumWithLeastPrimeFactor(value / prime_power, i + 1, prime_coefficients,
+                                                      prime_power_function) +
+                          prime_power_function(prime, exponent + 1);
+            }
+        }
+
+        return result;
+    }
+
     uint64_t ceil_;
+    std::array<unsigned, kSumsQuantity> degrees_;
     std::vector<uint64_t> subsqrts_and_paired_;
+    std::vector<Sums> sums_;
+    std::vector<uint64_t> primes_;
 };
 
 int main() {
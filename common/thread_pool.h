@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*! \class ThreadPool
+    \brief Persistent threads running one task on all of them at once
+
+    \param workers_ - threads besides the calling one, they sleep between calls
+    \param task_ - function that receives index of thread, the calling thread has index 0
+    \param generation_ - number of the current task, worker takes task when it differs from the last seen one
+    \param unfinished_quantity_ - quantity of workers that did not finish the current task
+
+    ParallelFor splits range into one part per thread, RunTasks lets threads take tasks one by one until they run out.
+*/
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads_quantity) {
+        assert(threads_quantity > 0);
+
+        workers_.reserve(threads_quantity - 1);
+        for (size_t worker = 1; worker < threads_quantity; ++worker) {
+            workers_.emplace_back([this, worker]() { Work(worker); });
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            is_stopped_ = true;
+        }
+        task_ready_.notify_all();
+        for (std::thread &worker : workers_) {
+            worker.join();
+        }
+    }
+
+    /// \brief Splits [begin, end) into one part per thread and waits until all parts are processed
+    /// \param function - callable receiving borders of part
+    template <typename Function>
+    void ParallelFor(uint64_t begin, uint64_t end, const Function &function) {
+        uint64_t parts_quantity = GetThreadsQuantity();
+        RunOnAllThreads([&](size_t part) {
+            function(begin + (end - begin) * part / parts_quantity,
+                     begin + (end - begin) * (part + 1) / parts_quantity);
+        });
+    }
+
+    /// \brief Runs tasks and waits until they are done, each thread takes the next task as soon as it finishes the
+    /// previous one
+    /// \param tasks_quantity - quantity of tasks
+    /// \param task - callable that receives index of task
+    template <typename Task>
+    void RunTasks(size_t tasks_quantity, const Task &task) {
+        std::atomic<size_t> next_task{0};
+        RunOnAllThreads([&](size_t) {
+            for (size_t task_index = next_task++; task_index < tasks_quantity; task_index = next_task++) {
+                task(task_index);
+            }
+        });
+    }
+
+    size_t GetThreadsQuantity() const {
+        return workers_.size() + 1;
+    }
+
+private:
+    /// \brief Runs task on every thread and waits for all of them; with no workers task just runs inline
+    void RunOnAllThreads(const std::function<void(size_t)> &task) {
+        if (workers_.empty()) {
+            task(0);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = task;
+            unfinished_quantity_ = workers_.size();
+            ++generation_;
+        }
+        task_ready_.notify_all();
+
+        task(0);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        task_done_.wait(lock, [this]() { return unfinished_quantity_ == 0; });
+        task_ = nullptr;
+    }
+
+    void Work(size_t worker) {
+        uint64_t seen_generation = 0;
+        while (true) {
+            std::function<void(size_t)> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                task_ready_.wait(lock, [&]() { return is_stopped_ || (generation_ != seen_generation); });
+                if (is_stopped_) {
+                    return;
+                }
+                seen_generation = generation_;
+                task = task_;
+            }
+
+            task(worker);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--unfinished_quantity_ == 0) {
+                task_done_.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable task_ready_;
+    std::condition_variable task_done_;
+    std::function<void(size_t)> task_;
+    uint64_t generation_ = 0;
+    size_t unfinished_quantity_ = 0;
+    bool is_stopped_ = false;
+};
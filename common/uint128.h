@@ -0,0 +1,4 @@
+#pragma once
+
+/// 128-bit unsigned integer is a GCC extension, __extension__ keeps -Wpedantic builds quiet
+__extension__ typedef unsigned __int128 UnsignedInt128;